@@ -23,6 +23,291 @@ PERL_STATIC_INLINE U32 CPerlCustom_SvHASH(pTHX_ SV *_Nonnull sv) {
 	return hash;
 }
 
+/// Creates and returns a new interpreter by cloning @c proto_perl.
+/// Returns @c NULL if Perl is built without ithreads support.
+SWIFT_NAME(PerlInterpreter.clone(self:_:))
+PERL_STATIC_INLINE PerlInterpreter *_Nullable CPerlCustom_perl_clone(PerlInterpreter *_Nonnull proto_perl, UV flags) {
+#ifdef USE_ITHREADS
+	return perl_clone(proto_perl, flags);
+#else
+	return NULL;
+#endif
+}
+
+/// Returns a number which is changed whenever any subroutine or method
+/// which can be found through @c stash is defined, redefined or removed
+/// and whenever @c @@ISA of the stash or of its ancestors is changed.
+SWIFT_NAME(PerlInterpreter.methodGeneration(self:_:))
+PERL_STATIC_INLINE U32 CPerlCustom_method_generation(pTHX_ HV *_Nonnull stash) {
+	struct mro_meta *meta = HvMROMETA(stash);
+	return PL_sub_generation + meta->pkg_gen + meta->cache_gen;
+}
+
+/// Returns the CV which would be called as the method @c name of objects
+/// blessed into @c stash or @c NULL if there is no such method.
+/// @c AUTOLOAD is not taken into account.
+SWIFT_NAME(PerlInterpreter.findMethod(self:_:_:_:_:))
+PERL_STATIC_INLINE CV *_Nullable CPerlCustom_find_method(pTHX_ HV *_Nonnull stash, const char *_Nonnull name, STRLEN len, bool utf8) {
+#ifdef gv_fetchmeth_pvn
+	GV *gv = gv_fetchmeth_pvn(stash, name, len, 0, utf8 ? SVf_UTF8 : 0);
+#else
+	GV *gv = gv_fetchmeth(stash, name, len, 0);
+#endif
+	return gv ? GvCV(gv) : NULL;
+}
+
+/// Returns the stash an object referenced by @c rv is blessed into
+/// or @c NULL if @c rv is not a reference to an object.
+SWIFT_NAME(objectStash(_:))
+PERL_STATIC_INLINE HV *_Nullable CPerlCustom_object_stash(SV *_Nonnull rv) {
+	return SvROK(rv) && SvOBJECT(SvRV(rv)) ? SvSTASH(SvRV(rv)) : NULL;
+}
+
+/// Returns whether an argument SV passed to a subroutine can be reused
+/// for another call: nobody but the caller references it, it is not magical,
+/// read-only, blessed or a reference and its string buffer is not larger
+/// than @c maxlen bytes.
+SWIFT_NAME(isReusableArgument(_:_:))
+PERL_STATIC_INLINE bool CPerlCustom_is_reusable_argument(SV *_Nonnull sv, STRLEN maxlen) {
+	return SvREFCNT(sv) == 1 && SvTYPE(sv) <= SVt_PVMG && !SvMAGICAL(sv) && !SvREADONLY(sv)
+		&& !SvOBJECT(sv) && !SvROK(sv) && (SvTYPE(sv) < SVt_PV || SvLEN(sv) <= maxlen);
+}
+
+/// Makes @c sv undefined keeping its body allocated.
+SWIFT_NAME(PerlInterpreter.setUndef(self:_:))
+PERL_STATIC_INLINE void CPerlCustom_sv_set_undef(pTHX_ SV *_Nonnull sv) {
+	sv_setsv(sv, &PL_sv_undef);
+}
+
+/// Callbacks of @c CPerlCustom_multicall. @c next fills @c args, which is
+/// @c @@_ of the next call, and returns false to stop. @c result receives
+/// the value returned by the call and returns false to stop.
+typedef struct {
+	CV *_Nonnull cv;
+	bool (*_Nonnull next)(pTHX_ AV *_Nonnull args, void *_Nullable info);
+	bool (*_Nonnull result)(pTHX_ SV *_Nonnull value, void *_Nullable info);
+	void *_Nullable info;
+} CPerlCustomMulticall;
+
+/// Calls @c mc->cv in scalar context again and again until one of
+/// the callbacks returns false. Pure Perl subroutines are called using
+/// the lightweight @c MULTICALL protocol, XSUBs are called by @c call_sv.
+/// Exceptions are not caught, so it should be run inside an @c eval.
+SWIFT_NAME(PerlInterpreter.multicall(self:_:))
+PERL_STATIC_INLINE void CPerlCustom_multicall(pTHX_ CPerlCustomMulticall *_Nonnull mc) {
+	CV *cv = mc->cv;
+	ENTER;
+	SAVETMPS;
+	save_ary(PL_defgv);
+	if (CvISXSUB(cv) || !CvROOT(cv)) {
+		for (;;) {
+			AV *args = newAV();
+			if (!mc->next(aTHX_ args, mc->info)) {
+				SvREFCNT_dec(args);
+				break;
+			}
+			dSP;
+			SSize_t i, count = av_len(args) + 1;
+			PUSHMARK(SP);
+			EXTEND(SP, count);
+			for (i = 0; i < count; i++) {
+				PUSHs(sv_2mortal(SvREFCNT_inc_simple_NN(AvARRAY(args)[i])));
+			}
+			PUTBACK;
+			SvREFCNT_dec(args);
+			call_sv((SV *)cv, G_SCALAR);
+			bool more = mc->result(aTHX_ *PL_stack_sp--, mc->info);
+			FREETMPS;
+			if (!more) break;
+		}
+	} else {
+		dSP;
+		dMULTICALL;
+		U8 gimme = G_SCALAR;
+		PUSH_MULTICALL(cv);
+		for (;;) {
+			AV *args = GvAV(PL_defgv);
+			if (SvREFCNT(args) > 1 || SvRMAGICAL(args)) {
+				// The callee kept a reference to @_ or made it magical, leave it alone
+				SvREFCNT_dec(args);
+				args = GvAV(PL_defgv) = newAV();
+			} else {
+				av_clear(args);
+			}
+			if (!mc->next(aTHX_ args, mc->info)) break;
+			MULTICALL;
+			if (!mc->result(aTHX_ *PL_stack_sp, mc->info)) break;
+		}
+		POP_MULTICALL;
+		PERL_UNUSED_VAR(gimme);
+		PERL_UNUSED_VAR(sp);
+	}
+	FREETMPS;
+	LEAVE;
+}
+
+/// An XSUB running @c CPerlCustom_multicall() for an address of
+/// @c CPerlCustomMulticall passed as the only argument.
+SWIFT_NAME(multicallXSub(_:_:))
+PERL_STATIC_INLINE void CPerlCustom_multicall_xsub(pTHX_ CV *_Nonnull cv) {
+	dXSARGS;
+	PERL_UNUSED_VAR(cv);
+	if (items != 1) croak("Usage: multicall(address)");
+	CPerlCustom_multicall(aTHX_ INT2PTR(CPerlCustomMulticall *, SvIV(ST(0))));
+	XSRETURN_EMPTY;
+}
+
+/// Returns the target SV of the op calling the current XSUB, which
+/// the XSUB can store its scalar result into (like @c dXSTARG does),
+/// or @c NULL if the op has no target.
+SWIFT_NAME(PerlInterpreter.xsTarget(self:))
+PERL_STATIC_INLINE SV *_Nullable CPerlCustom_xs_target(pTHX) {
+	return PL_op->op_private & OPpENTERSUB_HASTARG ? PAD_SV(PL_op->op_targ) : NULL;
+}
+
+/// Runs an @c entersub op compiled for a subroutine registered by
+/// @c CPerlCustom_register_call_op(). If the op calls an XSUB then
+/// the XSUB is called directly doing what the XSUB branch of
+/// @c pp_entersub does, otherwise (the subroutine has been redefined
+/// in Perl, the call is used as an lvalue, the debugger is active, etc.)
+/// @c pp_entersub is used.
+PERL_STATIC_INLINE OP *_Nullable CPerlCustom_pp_call_xsub(pTHX) {
+	dSP;
+	SV *sv = TOPs;
+	CV *cv = NULL;
+	if (SvROK(sv))
+		sv = SvRV(sv);
+	if (SvTYPE(sv) == SVt_PVGV)
+		cv = GvCVu((GV *)sv);
+	else if (SvTYPE(sv) == SVt_PVCV)
+		cv = (CV *)sv;
+	if (!cv || !CvISXSUB(cv) || !(PL_op->op_flags & OPf_STACKED) || PERLDB_SUB || TAINTING_get
+		// pp_entersub dies on an assignment to a call of a non-lvalue subroutine
+		|| ((PL_op->op_private & OPpENTERSUB_LVAL_MASK) == OPpLVAL_INTRO && !CvLVALUE(cv)))
+		return PL_ppaddr[OP_ENTERSUB](aTHX);
+	(void)POPs;
+	PUTBACK;
+	SSize_t markix = TOPMARK;
+	ENTER;
+	SAVETMPS;
+	// Pad temporaries are reused by the next execution of their ops, so the XSUB gets copies
+	SV **mark = PL_stack_base + markix;
+	while (mark < SP) {
+		mark++;
+		if (*mark && SvPADTMP(*mark))
+			*mark = sv_mortalcopy(*mark);
+	}
+	bool is_scalar = GIMME_V == G_SCALAR;
+	CvXSUB(cv)(aTHX_ cv);
+	// Enforce some sanity in scalar context the same way pp_entersub does
+	if (is_scalar) {
+		SV **svp = PL_stack_base + markix + 1;
+		if (svp != PL_stack_sp) {
+			*svp = svp > PL_stack_sp ? &PL_sv_undef : *PL_stack_sp;
+			PL_stack_sp = svp;
+		}
+	}
+	LEAVE;
+	return NORMAL;
+}
+
+/// A call checker replacing @c pp_entersub of ops calling the subroutine
+/// with @c CPerlCustom_pp_call_xsub().
+PERL_STATIC_INLINE OP *_Nonnull CPerlCustom_ck_call_xsub(pTHX_ OP *_Nonnull entersubop, GV *_Nonnull namegv, SV *_Nonnull ckobj) {
+	entersubop = ck_entersub_args_proto_or_list(entersubop, namegv, ckobj);
+	if (entersubop->op_type == OP_ENTERSUB)
+		entersubop->op_ppaddr = CPerlCustom_pp_call_xsub;
+	return entersubop;
+}
+
+/// Makes calls of @c cv compiled afterwards skip @c pp_entersub
+/// and enter the XSUB directly.
+SWIFT_NAME(PerlInterpreter.registerCallOp(self:_:))
+PERL_STATIC_INLINE void CPerlCustom_register_call_op(pTHX_ CV *_Nonnull cv) {
+	cv_set_call_checker(cv, CPerlCustom_ck_call_xsub, (SV *)cv);
+}
+
+/// Returns whether all the @c len bytes at @c s are ASCII characters, so
+/// a UTF-8 string does not need the UTF-8 flag. Uses word-at-a-time
+/// @c is_utf8_invariant_string() where available.
+SWIFT_NAME(isASCII(_:_:))
+PERL_STATIC_INLINE bool CPerlCustom_is_ascii(const char *_Nonnull s, STRLEN len) {
+#ifdef is_utf8_invariant_string
+	return is_utf8_invariant_string((const U8 *)s, len);
+#else
+	U8 all = 0;
+	for (STRLEN i = 0; i < len; i++)
+		all |= (U8)s[i];
+	return all < 0x80;
+#endif
+}
+
+/// Makes @c sv an empty byte string with a buffer for @c len bytes
+/// and returns the buffer. After the bytes are written into the buffer
+/// their number is set by @c CPerlCustom_set_buffer_length().
+SWIFT_NAME(PerlInterpreter.prepareBuffer(self:_:_:))
+PERL_STATIC_INLINE char *_Nonnull CPerlCustom_prepare_buffer(pTHX_ SV *_Nonnull sv, STRLEN len) {
+	sv_setpvn(sv, "", 0);
+	SvPOK_only(sv);
+	return SvGROW(sv, len + 1);
+}
+
+/// Sets the length of a string prepared by @c CPerlCustom_prepare_buffer().
+SWIFT_NAME(setBufferLength(_:_:))
+PERL_STATIC_INLINE void CPerlCustom_set_buffer_length(SV *_Nonnull sv, STRLEN len) {
+	SvCUR_set(sv, len);
+	*SvEND(sv) = '\0';
+}
+
+/// Returns the interpreter bound to the calling thread or NULL if there is none.
+SWIFT_NAME(getBoundInterpreter())
+PERL_STATIC_INLINE PerlInterpreter *_Nullable CPerlCustom_get_bound_interpreter(void) {
+	return PERL_GET_THX;
+}
+
+/// Binds @c p to the calling thread. NULL unbinds the current interpreter.
+SWIFT_NAME(setBoundInterpreter(_:))
+PERL_STATIC_INLINE void CPerlCustom_set_bound_interpreter(PerlInterpreter *_Nullable p) {
+	PERL_SET_THX(p);
+}
+
+// Atomics
+
+SWIFT_NAME(atomicLoadPointer(_:))
+PERL_STATIC_INLINE void *_Nullable CPerlCustom_atomic_load_ptr(void *_Nullable *_Nonnull ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+SWIFT_NAME(atomicStorePointer(_:_:))
+PERL_STATIC_INLINE void CPerlCustom_atomic_store_ptr(void *_Nullable *_Nonnull ptr, void *_Nullable value) {
+	__atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+SWIFT_NAME(atomicExchangePointer(_:_:))
+PERL_STATIC_INLINE void *_Nullable CPerlCustom_atomic_exchange_ptr(void *_Nullable *_Nonnull ptr, void *_Nullable value) {
+	return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+SWIFT_NAME(atomicLoadInt(_:))
+PERL_STATIC_INLINE long CPerlCustom_atomic_load_long(long *_Nonnull ptr) {
+	return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+}
+
+SWIFT_NAME(atomicStoreInt(_:_:))
+PERL_STATIC_INLINE void CPerlCustom_atomic_store_long(long *_Nonnull ptr, long value) {
+	__atomic_store_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
+SWIFT_NAME(atomicAddInt(_:_:))
+PERL_STATIC_INLINE long CPerlCustom_atomic_add_long(long *_Nonnull ptr, long value) {
+	return __atomic_add_fetch(ptr, value, __ATOMIC_RELAXED);
+}
+
+SWIFT_NAME(atomicExchangeInt(_:_:))
+PERL_STATIC_INLINE long CPerlCustom_atomic_exchange_long(long *_Nonnull ptr, long value) {
+	return __atomic_exchange_n(ptr, value, __ATOMIC_SEQ_CST);
+}
+
 // Backward compatibility
 
 /// This is an XS interface to Perl's @c die function.
@@ -0,0 +1,47 @@
+import CPerl
+
+extension PerlSub {
+	/// A parameter of a Swift subroutine referencing the argument passed by
+	/// the caller instead of its copy.
+	///
+	/// Parameters of types `PerlScalar` and `PerlObject` receive copies
+	/// of the arguments, which costs a SV allocation per argument on every
+	/// call. Wrapping such a parameter into `Borrowed` skips the copy:
+	///
+	/// ```swift
+	/// PerlSub(name: "is_empty") { (s: PerlSub.Borrowed<PerlScalar>) -> Bool in
+	///		return !s.value.defined
+	/// }
+	/// ```
+	///
+	/// The value is an alias of the argument, like elements of Perl's `@_`:
+	/// modifications of it are visible to the caller and it can be changed
+	/// by Perl after the subroutine returns. So it is meant to be read
+	/// during the call only and must not be stored anywhere.
+	/// For other types `Borrowed` makes no difference.
+	public struct Borrowed<Value : PerlScalarConvertible> : PerlScalarConvertible {
+		/// The argument passed by the caller.
+		public let value: Value
+
+		public init(_ value: Value) {
+			self.value = value
+		}
+
+		public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws {
+			value = try Value(_fromUnsafeSvContextInc: svc)
+		}
+
+		public init(_fromUnsafeSvContextCopy svc: UnsafeSvContext) throws {
+			value = try Value(_fromUnsafeSvContextInc: svc)
+		}
+
+		public static func _fromUnsafeArgument(_ svc: UnsafeSvContext?, at index: Int) throws -> Borrowed {
+			guard let svc = svc else { return Borrowed(try Value._fromUnsafeArgument(nil, at: index)) }
+			return try Borrowed(_fromUnsafeSvContextInc: svc)
+		}
+
+		public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer {
+			return value._toUnsafeSvPointer(perl: perl)
+		}
+	}
+}
@@ -1,3 +1,5 @@
+import CPerl
+
 extension String {
 	init(cString: UnsafePointer<CChar>, withLength length: Int) {
 		let utf8buffer = UnsafeBufferPointer(start: UnsafeRawPointer(cString).assumingMemoryBound(to: UInt8.self), count: length)
@@ -8,4 +10,12 @@ extension String {
 		let length = utf8.count
 		return try withCString { try body($0, length) }
 	}
+
+	/// Like `withCStringWithLength(_:)`, but also passes to `body` whether
+	/// the string contains only ASCII characters. It is detected by a single
+	/// pass over UTF-8 bytes, which checks a machine word at a time.
+	func withCStringCheckingASCII<Result>(_ body: (UnsafePointer<CChar>, Int, Bool) throws -> Result) rethrows -> Result {
+		let length = utf8.count
+		return try withCString { try body($0, length, isASCII($0, length)) }
+	}
 }
@@ -0,0 +1,120 @@
+import CPerl
+
+/// Anonymous subroutines compiled by `PerlInterpreter.compile(_:)`
+/// keyed by their source. The least recently used ones are evicted
+/// when the cache is full.
+final class PerlCompiledCache {
+	private struct Entry {
+		let sub: PerlSub
+		var lastUse: UInt64
+	}
+
+	private var entries: [String: Entry] = [:]
+	private var clock: UInt64 = 0
+
+	var capacity = 256 {
+		didSet { evict(keeping: capacity) }
+	}
+
+	private(set) var hits = 0
+	private(set) var misses = 0
+	private(set) var evictions = 0
+
+	var count: Int {
+		return entries.count
+	}
+
+	func lookup(_ source: String) -> PerlSub? {
+		clock += 1
+		guard let index = entries.index(forKey: source) else {
+			misses += 1
+			return nil
+		}
+		hits += 1
+		entries.values[index].lastUse = clock
+		return entries.values[index].sub
+	}
+
+	func insert(_ sub: PerlSub, for source: String) {
+		guard capacity > 0 else { return }
+		evict(keeping: capacity - 1)
+		entries[source] = Entry(sub: sub, lastUse: clock)
+	}
+
+	/// Evicts the least recently used entries until no more than `count` are left.
+	/// A linear scan is cheap compared to the compilation which caused the eviction.
+	private func evict(keeping count: Int) {
+		while entries.count > max(count, 0) {
+			let oldest = entries.min { $0.value.lastUse < $1.value.lastUse }!
+			entries.removeValue(forKey: oldest.key)
+			evictions += 1
+		}
+	}
+
+	func removeAll() {
+		entries = [:]
+	}
+}
+
+extension PerlInterpreter {
+	/// Counters of the cache of subroutines compiled by `compile(_:)`.
+	public struct CompileCacheStatistics {
+		/// A number of cached subroutines.
+		public let count: Int
+
+		/// The maximal number of cached subroutines.
+		public let capacity: Int
+
+		/// A number of calls to `compile(_:)` which found the subroutine in the cache.
+		public let hits: Int
+
+		/// A number of calls to `compile(_:)` which had to compile the source.
+		public let misses: Int
+
+		/// A number of subroutines evicted from the cache.
+		public let evictions: Int
+	}
+
+	/// Compiles the source as a body of an anonymous subroutine and returns it.
+	///
+	/// Unlike `eval(_:)` the source is parsed only once: compiled subroutines
+	/// are kept in a bounded cache keyed by the source, so subsequent calls
+	/// with the same source return the same subroutine without invoking
+	/// the Perl parser. Arguments of the call are available in `@_`.
+	///
+	/// ```swift
+	/// let rule = try perl.compile("return $_[0] > 10")
+	/// let matches: Bool = try rule.call(value)
+	/// ```
+	///
+	/// The subroutine is compiled in package `main` and does not see
+	/// lexical variables of the caller.
+	///
+	/// - Parameter source: Perl code of the subroutine body.
+	/// - Returns: The compiled subroutine.
+	/// - Throws: `PerlError.died` if the source cannot be compiled.
+	///   Failures are not cached.
+	public func compile(_ source: String) throws -> PerlSub {
+		let cache = context.compiled
+		if let sub = cache.lookup(source) {
+			return sub
+		}
+		let sub: PerlSub = try eval("package main; sub {\n#line 1\n\(source)\n}")
+		cache.insert(sub, for: source)
+		return sub
+	}
+
+	/// The maximal number of subroutines kept by `compile(_:)`.
+	/// Defaults to 256. Zero disables caching.
+	public var compileCacheCapacity: Int {
+		get { return context.compiled.capacity }
+		nonmutating set { context.compiled.capacity = newValue }
+	}
+
+	/// A snapshot of the counters of the cache of compiled subroutines.
+	public var compileCacheStatistics: CompileCacheStatistics {
+		let cache = context.compiled
+		return CompileCacheStatistics(count: cache.count, capacity: cache.capacity,
+			hits: cache.hits, misses: cache.misses, evictions: cache.evictions)
+	}
+}
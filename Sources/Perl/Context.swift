@@ -0,0 +1,191 @@
+import CPerl
+
+/// Swift state attached to a Perl interpreter.
+///
+/// The context is referenced from the magic of a SV stored in `PL_modglobal`,
+/// so it is freed together with the interpreter. A clone of the interpreter
+/// gets its own empty context.
+final class PerlInterpreterContext {
+	private struct MethodKey : Hashable {
+		let stash: UnsafeHvPointer
+		let name: String
+	}
+
+	private struct Method {
+		let cv: UnsafeCvPointer?
+		let generation: UInt32
+	}
+
+	private struct NamedClass {
+		let stash: UnsafeHvPointer?
+		let name: UnsafeSvPointer
+	}
+
+	private var methods: [MethodKey: Method] = [:]
+
+	/// The number of cached methods at which the cache is cleaned up,
+	/// see `method(_:in:perl:)`.
+	static let methodCacheLimit = 1024
+	private var classes: [String: NamedClass] = [:]
+
+	/// SVs reused as arguments of calls.
+	let arguments = UnsafeArgumentPool()
+
+	/// Subroutines compiled by `PerlInterpreter.compile(_:)`.
+	let compiled = PerlCompiledCache()
+
+	private var multicall: UnsafeCvPointer?
+
+	/// Whether `Swift::Stats` subroutines are defined, see `PerlSub.collectsStatistics`.
+	var statisticsSubsDefined = false
+
+	/// Releases all the SVs referenced by the context.
+	func free(perl: PerlInterpreter) {
+		arguments.free(perl: perl)
+		compiled.removeAll()
+		if let cv = multicall {
+			perl.pointee.SvREFCNT_dec_NN(UnsafeMutableRawPointer(cv).assumingMemoryBound(to: SV.self))
+			multicall = nil
+		}
+		for (key, method) in methods {
+			release(key, method, perl: perl)
+		}
+		methods = [:]
+		for (_, named) in classes {
+			perl.pointee.SvREFCNT_dec(named.stash.map { UnsafeMutableRawPointer($0).assumingMemoryBound(to: SV.self) })
+			perl.pointee.SvREFCNT_dec_NN(named.name)
+		}
+		classes = [:]
+	}
+
+	/// Returns the CV implementing the method `name` for objects blessed
+	/// into `stash` or `nil` if the method cannot be resolved without
+	/// Perl's help (`AUTOLOAD`, `SUPER::` and the like).
+	///
+	/// Resolved methods are cached until the method generation of the stash changes.
+	/// When the cache grows to `methodCacheLimit` entries, the stale ones are
+	/// evicted, or the whole cache if none are stale, so stashes and CVs
+	/// of classes no longer called are not kept alive forever.
+	func method(_ name: String, in stash: UnsafeHvPointer, perl: PerlInterpreter) -> UnsafeCvPointer? {
+		let key = MethodKey(stash: stash, name: name)
+		let generation = perl.pointee.methodGeneration(stash)
+		if let cached = methods[key] {
+			if cached.generation == generation {
+				return cached.cv
+			}
+			methods[key] = nil
+			release(key, cached, perl: perl)
+		}
+		if methods.count >= PerlInterpreterContext.methodCacheLimit {
+			evictMethods(perl: perl)
+		}
+		SvREFCNT_inc_NN(UnsafeMutableRawPointer(stash).assumingMemoryBound(to: SV.self))
+		var cv: UnsafeCvPointer?
+		if !name.contains(":") && !name.contains("'") {
+			cv = name.withCStringCheckingASCII { perl.pointee.findMethod(stash, $0, $1, !$2) }
+			if let cv = cv {
+				SvREFCNT_inc_NN(UnsafeMutableRawPointer(cv).assumingMemoryBound(to: SV.self))
+			}
+		}
+		methods[key] = Method(cv: cv, generation: generation)
+		return cv
+	}
+
+	/// The number of currently cached methods.
+	var cachedMethodCount: Int {
+		return methods.count
+	}
+
+	private func evictMethods(perl: PerlInterpreter) {
+		let stale = methods.filter { $0.value.generation != perl.pointee.methodGeneration($0.key.stash) }
+		for (key, method) in stale {
+			methods[key] = nil
+			release(key, method, perl: perl)
+		}
+		if methods.count >= PerlInterpreterContext.methodCacheLimit {
+			for (key, method) in methods {
+				release(key, method, perl: perl)
+			}
+			methods = [:]
+		}
+	}
+
+	private func release(_ key: MethodKey, _ method: Method, perl: PerlInterpreter) {
+		perl.pointee.SvREFCNT_dec(UnsafeMutableRawPointer(key.stash).assumingMemoryBound(to: SV.self))
+		perl.pointee.SvREFCNT_dec(method.cv.map { UnsafeMutableRawPointer($0).assumingMemoryBound(to: SV.self) })
+	}
+
+	/// Returns an anonymous XSUB running `CPerlCustom_multicall()`.
+	/// See `PerlSub.multicall(next:result:)`.
+	func multicallSv(perl: PerlInterpreter) -> UnsafeSvPointer {
+		if multicall == nil {
+			multicall = perl.pointee.newXS(nil, multicallXSub, #file)
+		}
+		return UnsafeMutableRawPointer(multicall!).assumingMemoryBound(to: SV.self)
+	}
+
+	/// Returns the stash of a class and a shared read-only SV containing its name.
+	/// The SV is a template: a callee may assign to its invocant, so calls
+	/// should pass a mortal copy of it.
+	func namedClass(_ name: String, perl: PerlInterpreter) -> (stash: UnsafeHvPointer?, name: UnsafeSvPointer) {
+		if let named = classes[name], named.stash != nil {
+			return (named.stash, named.name)
+		}
+		let stash = perl.getHV(name + "::")
+		if let stash = stash {
+			SvREFCNT_inc_NN(UnsafeMutableRawPointer(stash).assumingMemoryBound(to: SV.self))
+		}
+		let sv: UnsafeSvPointer
+		if let named = classes[name] {
+			sv = named.name
+		} else {
+			sv = perl.newSV(name)
+			sv.pointee.sv_flags |= UInt32(SVf_READONLY)
+		}
+		classes[name] = NamedClass(stash: stash, name: sv)
+		return (stash, sv)
+	}
+}
+
+private let contextKey = "Swift::Perl::context"
+
+private var contextMgvtbl = MGVTBL(
+	svt_get: nil,
+	svt_set: nil,
+	svt_len: nil,
+	svt_clear: nil,
+	svt_free: {
+		(perl, sv, magic) in
+		let u = Unmanaged<PerlInterpreterContext>.fromOpaque(UnsafeRawPointer(magic.unsafelyUnwrapped.pointee.mg_ptr!))
+		u.takeUnretainedValue().free(perl: PerlInterpreter(perl.unsafelyUnwrapped))
+		u.release()
+		return 0
+	},
+	svt_copy: nil,
+	svt_dup: {
+		(perl, magic, param) in
+		// Called by perl_clone(): cached SVs belong to the original interpreter.
+		let u = Unmanaged.passRetained(PerlInterpreterContext())
+		magic.unsafelyUnwrapped.pointee.mg_ptr = u.toOpaque().assumingMemoryBound(to: CChar.self)
+		return 0
+	},
+	svt_local: nil
+)
+
+extension PerlInterpreter {
+	/// Swift state attached to the interpreter. Created on first access.
+	var context: PerlInterpreterContext {
+		let modglobal = UnsafeHvContext(hv: pointee.Imodglobal, perl: self)
+		if let svc = modglobal.fetch(contextKey),
+			let magic = pointee.mg_findext(svc.sv, PERL_MAGIC_ext, &contextMgvtbl) {
+			return Unmanaged<PerlInterpreterContext>.fromOpaque(UnsafeRawPointer(magic.pointee.mg_ptr!)).takeUnretainedValue()
+		}
+		let context = PerlInterpreterContext()
+		let u = Unmanaged.passRetained(context)
+		let sv = pointee.newSV(0)
+		let magic = pointee.sv_magicext(sv, nil, PERL_MAGIC_ext, &contextMgvtbl, u.toOpaque().assumingMemoryBound(to: CChar.self), 0)
+		magic.pointee.mg_flags |= UInt8(MGf_DUP)
+		modglobal.store(contextKey, value: sv)
+		return context
+	}
+}
@@ -1,8 +1,12 @@
 import CPerl
 #if os(Linux) || os(FreeBSD) || os(PS4) || os(Android) || CYGWIN
 import func Glibc.atexit
+import func Glibc.strdup
+import func Glibc.free
 #elseif os(macOS) || os(iOS) || os(watchOS) || os(tvOS)
 import func Darwin.atexit
+import func Darwin.strdup
+import func Darwin.free
 #endif
 
 private var perlInitialized: Bool = {
@@ -11,6 +15,16 @@ private var perlInitialized: Bool = {
 	return true
 }()
 
+// An argv which lives as long as the process. It replaces the arguments
+// of perl_parse() in PL_origargv, which is kept by interpreters and
+// their clones for their whole lifetime.
+private let persistentArgv: UnsafeMutablePointer<UnsafeMutablePointer<CChar>?> = {
+	let argv = UnsafeMutablePointer<UnsafeMutablePointer<CChar>?>.allocate(capacity: 2)
+	argv[0] = strdup("")
+	argv[1] = nil
+	return argv
+}()
+
 extension PerlInterpreter {
 	static func sysInit() {
 		var argc = CommandLine.argc
@@ -28,30 +42,168 @@ extension PerlInterpreter {
 		_ = perlInitialized
 		let perl = PerlInterpreter(Pointee.alloc()!)
 		perl.pointee.construct()
-		perl.embed()
+		let status = perl.embed(arguments: ["-e", "0"])
+		assert(status == 0)
 		return perl
 	}
 
+	/// Options of an embedded Perl interpreter construction.
+	public struct Options {
+		/// Directories to prepend to `@INC`, the same as `-I` switches.
+		public var includePaths: [String]
+
+		/// Modules to load during the startup, the same as `-M` switches.
+		/// Import lists are supported: `"POSIX=floor,ceil"`.
+		public var preload: [String]
+
+		/// Any other command line switches, for example `"-w"` or `"-Mstrict"`.
+		public var switches: [String]
+
+		public init(includePaths: [String] = [], preload: [String] = [], switches: [String] = []) {
+			self.includePaths = includePaths
+			self.preload = preload
+			self.switches = switches
+		}
+
+		var arguments: [String] {
+			return includePaths.map { "-I" + $0 } + preload.map { "-M" + $0 } + switches + ["-e", "0"]
+		}
+	}
+
+	/// Durations of the interpreter startup phases in seconds.
+	public struct StartupTiming {
+		/// Allocation and construction of the interpreter (`perl_alloc()`, `perl_construct()`).
+		public var construct: Double = 0
+
+		/// Parsing of the command line including loading of preloaded modules (`perl_parse()`).
+		public var parse: Double = 0
+
+		/// Running of `INIT` blocks and the main program (`perl_run()`).
+		public var run: Double = 0
+
+		/// The total duration of the startup.
+		public var total: Double {
+			return construct + parse + run
+		}
+
+		public init() {}
+	}
+
+	/// Creates a new embedded Perl interpreter.
+	///
+	/// All the include paths, preloaded modules and switches are processed
+	/// by Perl itself during the startup in a single pass, much like
+	/// `perl -Ilib -MFoo -MBar -e 0` does. It is faster than loading
+	/// modules one by one using `require(_:)` afterwards.
+	///
+	/// The interpreter is not made current: the current interpreter
+	/// of the calling thread stays the same whether startup succeeds or not.
+	///
+	/// - Parameter options: Options of the interpreter.
+	/// - Throws: `PerlError.startupFailed` if a module cannot be loaded or
+	///   some switch is invalid. The interpreter is destroyed in this case.
+	///   The message is the error of the failed `BEGIN` or `INIT` block.
+	///   Perl reports invalid switches only to the standard error, so
+	///   the message just names the exit status then.
+	public static func new(options: Options) throws -> PerlInterpreter {
+		var timing = StartupTiming()
+		return try new(options: options, timing: &timing)
+	}
+
+	/// Creates a new embedded Perl interpreter and reports durations
+	/// of its startup phases in `timing`.
+	///
+	/// - SeeAlso: `new(options:)`
+	public static func new(options: Options, timing: inout StartupTiming) throws -> PerlInterpreter {
+		_ = perlInitialized
+		// perl_alloc() binds the new interpreter to the calling thread
+		let bound = PerlInterpreter.bound
+		defer { PerlInterpreter.bound = bound }
+		let start = monotonicTime()
+		let perl = PerlInterpreter(Pointee.alloc()!)
+		perl.pointee.construct()
+		let constructed = monotonicTime()
+		var status = perl.embed(arguments: options.arguments)
+		let parsed = monotonicTime()
+		if status == 0 {
+			status = perl.pointee.run()
+		}
+		let finished = monotonicTime()
+		timing.construct = Double(constructed - start) / 1e9
+		timing.parse = Double(parsed - constructed) / 1e9
+		timing.run = Double(finished - parsed) / 1e9
+		guard status == 0 else {
+			// Failed BEGIN and INIT blocks leave their error in $@ (the message
+			// is printed to stderr as well). Invalid switches are reported to
+			// stderr only and PL_errgv may not even be created yet then.
+			var message = perl.pointee.Ierrgv != nil ? (try? String(perl.error)) ?? "" : ""
+			if message.isEmpty {
+				message = "Perl startup failed with exit status \(status)"
+			}
+			perl.destroy()
+			throw PerlError.startupFailed(status: Int(status), message: message)
+		}
+		return perl
+	}
+
+	/// Creates a new Perl interpreter as a copy of this one.
+	///
+	/// All the loaded modules, compiled subroutines and global data of the
+	/// interpreter are duplicated, so it is much faster than creating a new
+	/// interpreter and loading everything again. This is the way to start
+	/// worker interpreters from a warmed-up parent.
+	///
+	/// XSUBs created from Swift closures are shared by both interpreters
+	/// and so are Swift objects bridged to Perl (`PerlBridgedObject`).
+	/// Closures should not capture `PerlValue`s of the original interpreter
+	/// if they are called from the clone.
+	///
+	/// Perl should be built with ithreads support.
+	/// `perl_clone()` works on the current interpreter, so `self` is made
+	/// current for the duration of the call. Then the previous current
+	/// interpreter of the calling thread is restored.
+	public func clone() -> PerlInterpreter {
+		let bound = PerlInterpreter.bound
+		PerlInterpreter.current = self
+		defer { PerlInterpreter.bound = bound }
+		guard let pointer = pointee.clone(0) else {
+			fatalError("Perl is built without ithreads support, cloning of interpreters is impossible")
+		}
+		return PerlInterpreter(pointer)
+	}
+
 	/// Shuts down the Perl interpreter.
 	public func destroy() {
 		pointee.destruct()
 		pointee.free()
 	}
 
-	func embed() {
+	/// Shuts down the Perl interpreter without the full leak and scope
+	/// balance checking enabled by `embed()`. Everything is still freed:
+	/// destruct level 0 would leave SV arenas allocated for the lifetime
+	/// of the process.
+	func destroyQuickly() {
+		pointee.Iperl_destruct_level = 1
+		destroy()
+	}
+
+	func embed(arguments: [String]) -> Int32 {
 		pointee.Iorigalen = 1
 		pointee.Iperl_destruct_level = 2
 		pointee.Iexit_flags |= UInt8(PERL_EXIT_DESTRUCT_END)
-		let args: StaticString = "\0-e\00\0"
-		args.withUTF8Buffer {
-			$0.baseAddress!.withMemoryRebound(to: CChar.self, capacity: $0.count) {
-				let start = UnsafeMutablePointer<CChar>(mutating: $0)
-				var cargs: [UnsafeMutablePointer<CChar>?] = [start, start + 1, start + 4]
-				let status = cargs.withUnsafeMutableBufferPointer {
-					pointee.parse(xs_init, Int32($0.count), $0.baseAddress, nil)
-				}
-				assert(status == 0)
-			}
+		// perl_parse() copies arguments into @ARGV, $0 and the like, but keeps
+		// argv itself in PL_origargv. Iorigalen = 1 stops assignments to $0
+		// from overwriting it. The arguments are freed after the call, so
+		// PL_origargv is pointed at an argv which outlives the interpreter.
+		let strings = ([""] + arguments).map { strdup($0)! }
+		defer { strings.forEach { free($0) } }
+		var cargs = strings.map { Optional($0) }
+		cargs.append(nil)
+		let status = cargs.withUnsafeMutableBufferPointer {
+			pointee.parse(xs_init, Int32($0.count - 1), $0.baseAddress, nil)
 		}
+		pointee.Iorigargv = persistentArgv
+		pointee.Iorigargc = 1
+		return status
 	}
 }
@@ -36,4 +36,14 @@ public enum PerlError : Error {
 
 	/// Odd number of elements in hash assignment.
 	case oddElementsHash
+
+	/// A call returned more values than a tuple it is converted to has elements.
+	case tooManyReturnValues(count: Int, want: Int)
+
+	/// A job was submitted to `PerlExecutor` after it was shut down.
+	case executorShutDown
+
+	/// An embedded interpreter failed to start. Perl's exit status and
+	/// the error message if any are in associated values.
+	case startupFailed(status: Int, message: String)
 }
@@ -0,0 +1,288 @@
+import CPerl
+
+/// Intrusive multi-producer single-consumer queue by Dmitry Vyukov.
+///
+/// `push(_:)` is lock-free and can be called from any thread,
+/// `pop()` and `isEmpty` must be called from the single consumer thread only.
+final class MPSCQueue<Element> {
+	private struct Node {
+		var next: UnsafeMutableRawPointer?
+		var element: Element?
+	}
+
+	private let stub = UnsafeMutablePointer<Node>.allocate(capacity: 1)
+	private var head: UnsafeMutablePointer<Node>
+	private let tail = UnsafeMutablePointer<UnsafeMutableRawPointer?>.allocate(capacity: 1)
+
+	init() {
+		stub.initialize(to: Node(next: nil, element: nil))
+		head = stub
+		tail.initialize(to: UnsafeMutableRawPointer(stub))
+	}
+
+	deinit {
+		while pop() != nil {}
+		stub.deinitialize(count: 1)
+		stub.deallocate()
+		tail.deinitialize(count: 1)
+		tail.deallocate()
+	}
+
+	private static func next(of node: UnsafeMutablePointer<Node>) -> UnsafeMutablePointer<UnsafeMutableRawPointer?> {
+		return (UnsafeMutableRawPointer(node) + MemoryLayout<Node>.offset(of: \Node.next)!)
+			.assumingMemoryBound(to: UnsafeMutableRawPointer?.self)
+	}
+
+	private static func load(next node: UnsafeMutablePointer<Node>) -> UnsafeMutablePointer<Node>? {
+		return atomicLoadPointer(next(of: node))?.assumingMemoryBound(to: Node.self)
+	}
+
+	private func push(node: UnsafeMutablePointer<Node>) {
+		MPSCQueue.next(of: node).pointee = nil
+		let prev = atomicExchangePointer(tail, UnsafeMutableRawPointer(node))!.assumingMemoryBound(to: Node.self)
+		atomicStorePointer(MPSCQueue.next(of: prev), UnsafeMutableRawPointer(node))
+	}
+
+	func push(_ element: Element) {
+		let node = UnsafeMutablePointer<Node>.allocate(capacity: 1)
+		node.initialize(to: Node(next: nil, element: element))
+		push(node: node)
+	}
+
+	/// Returns `nil` if the queue is empty or a producer has not
+	/// finished linking its node yet.
+	func pop() -> Element? {
+		var first = head
+		var next = MPSCQueue.load(next: first)
+		if first == stub {
+			guard let n = next else { return nil }
+			head = n
+			first = n
+			next = MPSCQueue.load(next: n)
+		}
+		if let n = next {
+			head = n
+			return take(first)
+		}
+		guard UnsafeMutableRawPointer(first) == atomicLoadPointer(tail) else { return nil }
+		push(node: stub)
+		if let n = MPSCQueue.load(next: first) {
+			head = n
+			return take(first)
+		}
+		return nil
+	}
+
+	private func take(_ node: UnsafeMutablePointer<Node>) -> Element? {
+		let element = node.pointee.element
+		node.deinitialize(count: 1)
+		node.deallocate()
+		return element
+	}
+
+	/// `false` also if some producer is in the middle of `push(_:)`.
+	var isEmpty: Bool {
+		return head == stub && MPSCQueue.load(next: stub) == nil && atomicLoadPointer(tail) == UnsafeMutableRawPointer(stub)
+	}
+}
+
+/// An executor running jobs on a dedicated thread owning a Perl interpreter.
+///
+/// Jobs can be submitted from any thread without taking locks. The executor
+/// thread processes them in batches: every batch is run inside one Perl scope
+/// (`ENTER`/`SAVETMPS` ... `FREETMPS`/`LEAVE`) and temporaries are freed
+/// after every job. The interpreter is the current one for the executor
+/// thread, so all the usual APIs can be used inside jobs.
+///
+/// ```swift
+/// let executor = PerlExecutor()
+/// executor.submit { perl in
+///		try! perl.require("My::App")
+/// }
+/// // Swift 5.5+
+/// let count: Int = try await executor.run { perl in
+///		try perl.call(sub: "My::App::count")
+/// }
+/// executor.shutdown()
+/// ```
+///
+/// With Swift 5.5 and later `PerlExecutor` is a `SerialExecutor` and can be
+/// used as a custom executor of actors which need to call Perl.
+public final class PerlExecutor {
+	/// A unit of work run on the executor thread.
+	public typealias Job = (PerlInterpreter) -> Void
+
+	private enum Message {
+		case job(Job)
+		case stop
+	}
+
+	private let perl: PerlInterpreter?
+	private let queue = MPSCQueue<Message>()
+	private let sleeping = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+	private let stopped = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+	private let mutex = Mutex()
+	private let wakeup = Condition()
+	private var thread: PosixThread!
+
+	/// The maximal number of jobs run inside one Perl scope.
+	public let batchSize: Int
+
+	/// Starts an executor thread owning `perl`.
+	///
+	/// The interpreter must not be used by other threads afterwards.
+	/// If it is the current interpreter of the calling thread, the thread
+	/// is left without one. The interpreter is destroyed by `shutdown()`.
+	///
+	/// - Parameter perl: An interpreter to run jobs on. If not specified
+	///   (or `nil` passed) then a new interpreter is created on the executor
+	///   thread, so the calling thread is not bound to it.
+	/// - Parameter batchSize: The maximal number of jobs run inside one Perl scope.
+	public init(perl: PerlInterpreter? = nil, batchSize: Int = 64) {
+		precondition(batchSize > 0, "Batch size should be positive")
+		if let perl = perl, PerlInterpreter.bound?.pointer == perl.pointer {
+			PerlInterpreter.bound = nil
+		}
+		self.perl = perl
+		self.batchSize = batchSize
+		sleeping.initialize(to: 0)
+		stopped.initialize(to: 0)
+		thread = PosixThread { self.main() }
+	}
+
+	deinit {
+		sleeping.deinitialize(count: 1)
+		sleeping.deallocate()
+		stopped.deinitialize(count: 1)
+		stopped.deallocate()
+	}
+
+	/// Whether `shutdown()` was called.
+	public var isShutDown: Bool {
+		return atomicLoadInt(stopped) != 0
+	}
+
+	/// Schedules `job` to be run on the executor thread.
+	/// Jobs are run in the order of submission.
+	///
+	/// Must not be called after `shutdown()`: nothing would ever run the job.
+	public func submit(_ job: @escaping Job) {
+		precondition(!isShutDown, "Cannot submit jobs to executor after shutdown")
+		send(.job(job))
+	}
+
+	/// Runs all the jobs submitted before, stops the executor thread
+	/// and destroys its interpreter. Blocks until the thread finishes.
+	///
+	/// Must not be called from inside a job or concurrently with
+	/// submission of jobs.
+	public func shutdown() {
+		precondition(!thread.isCurrent, "Cannot shut down executor from its own thread")
+		let wasStopped = atomicExchangeInt(stopped, 1)
+		precondition(wasStopped == 0, "Executor is already shut down")
+		send(.stop)
+		thread.join()
+	}
+
+	private func send(_ message: Message) {
+		queue.push(message)
+		if atomicLoadInt(sleeping) != 0 {
+			mutex.lock()
+			wakeup.signal()
+			mutex.unlock()
+		}
+	}
+
+	private func park() {
+		mutex.lock()
+		atomicStoreInt(sleeping, 1)
+		while queue.isEmpty {
+			wakeup.wait(mutex)
+		}
+		atomicStoreInt(sleeping, 0)
+		mutex.unlock()
+	}
+
+	private func main() {
+		let perl = self.perl ?? PerlInterpreter.new()
+		PerlInterpreter.current = perl
+		var batch: [Job] = []
+		batch.reserveCapacity(batchSize)
+		var running = true
+		while running {
+			while running && batch.count < batchSize, let message = queue.pop() {
+				switch message {
+					case .job(let job):
+						batch.append(job)
+					case .stop:
+						running = false
+				}
+			}
+			if batch.isEmpty {
+				if running {
+					park()
+				}
+				continue
+			}
+			perl.enterScope()
+			for job in batch {
+				job(perl)
+				perl.pointee.FREETMPS()
+			}
+			perl.leaveScope()
+			batch.removeAll(keepingCapacity: true)
+		}
+		perl.destroy()
+	}
+}
+
+#if swift(>=5.5) && canImport(_Concurrency)
+extension PerlExecutor : @unchecked Sendable {}
+
+extension PerlExecutor : SerialExecutor {
+#if compiler(>=5.9)
+	@available(macOS 14.0, iOS 17.0, watchOS 10.0, tvOS 17.0, *)
+	public func enqueue(_ job: consuming ExecutorJob) {
+		let job = UnownedJob(job)
+		submit { _ in
+			job.runSynchronously(on: self.asUnownedSerialExecutor())
+		}
+	}
+#endif
+
+	public func enqueue(_ job: UnownedJob) {
+		submit { _ in
+#if swift(>=5.9)
+			job.runSynchronously(on: self.asUnownedSerialExecutor())
+#else
+			job._runSynchronously(on: self.asUnownedSerialExecutor())
+#endif
+		}
+	}
+
+	public func asUnownedSerialExecutor() -> UnownedSerialExecutor {
+		return UnownedSerialExecutor(ordinary: self)
+	}
+}
+
+extension PerlExecutor {
+	/// Runs `body` on the executor thread and returns its result.
+	///
+	/// - Throws: `PerlError.executorShutDown` if the executor is shut down
+	///   or an error thrown by `body`.
+	public func run<R>(_ body: @escaping (PerlInterpreter) throws -> R) async throws -> R {
+		guard !isShutDown else {
+			throw PerlError.executorShutDown
+		}
+		return try await withCheckedThrowingContinuation { continuation in
+			submit { perl in
+				do {
+					continuation.resume(returning: try body(perl))
+				} catch {
+					continuation.resume(throwing: error)
+				}
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,99 @@
+import CPerl
+
+extension PerlSub {
+	/// A named Perl subroutine resolved once and called directly afterwards.
+	///
+	/// Calling a subroutine by its name requires creation of a SV containing
+	/// the name and a lookup in the symbol table on every call. A handle
+	/// caches the resolved subroutine and looks it up again only after
+	/// some subroutine in its package is (re)defined or removed.
+	///
+	/// ```swift
+	/// let handle = perl.resolve("My::App::handle")
+	/// for request in requests {
+	///		try handle.call(request) as Void
+	/// }
+	/// ```
+	///
+	/// If the subroutine does not exist the call is performed by name,
+	/// so `AUTOLOAD` and "Undefined subroutine" errors work as usual.
+	public final class Handle {
+		/// The fully qualified name of the subroutine.
+		public let name: String
+
+		let perl: PerlInterpreter
+		private let packageName: String
+		private var stash: UnsafeHvPointer?
+		private var cv: UnsafeCvPointer?
+		private var generation: UInt32 = 0
+
+		init(name: String, perl: PerlInterpreter) {
+			self.name = name
+			self.perl = perl
+			if let last = name.lastIndex(of: ":"), last != name.startIndex,
+				case let colon = name.index(before: last), name[colon] == ":", colon != name.startIndex {
+				packageName = String(name[..<colon])
+			} else {
+				packageName = "main"
+			}
+			resolve()
+		}
+
+		deinit {
+			release()
+		}
+
+		private func release() {
+			if let cv = cv {
+				UnsafeCvContext(cv: cv, perl: perl).withUnsafeSvContext { $0.refcntDec() }
+				self.cv = nil
+			}
+			if let stash = stash {
+				UnsafeHvContext(hv: stash, perl: perl).withUnsafeSvContext { $0.refcntDec() }
+				self.stash = nil
+			}
+		}
+
+		private func resolve() {
+			release()
+			if let hv = perl.getHV(packageName + "::") {
+				UnsafeHvContext(hv: hv, perl: perl).withUnsafeSvContext { _ = $0.refcntInc() }
+				stash = hv
+				generation = perl.pointee.methodGeneration(hv)
+			}
+			if stash != nil, let cv = perl.getCV(name) {
+				UnsafeCvContext(cv: cv, perl: perl).withUnsafeSvContext { _ = $0.refcntInc() }
+				self.cv = cv
+			}
+		}
+
+		/// A SV to pass to `call_sv`. Must be called inside a scope.
+		func unsafeSv() -> UnsafeSvPointer {
+			if stash == nil || perl.pointee.methodGeneration(stash!) != generation {
+				resolve()
+			}
+			if let cv = cv {
+				return UnsafeMutableRawPointer(cv).assumingMemoryBound(to: SV.self)
+			}
+			return perl.newSV(name, mortal: true)
+		}
+
+		/// Whether the subroutine exists.
+		public var isDefined: Bool {
+			if stash == nil || perl.pointee.methodGeneration(stash!) != generation {
+				resolve()
+			}
+			return cv != nil
+		}
+	}
+}
+
+extension PerlInterpreter {
+	/// Resolves the Perl subroutine by its fully qualified name
+	/// and returns a handle to call it efficiently.
+	///
+	/// - SeeAlso: `PerlSub.Handle`
+	public func resolve(_ name: String) -> PerlSub.Handle {
+		return PerlSub.Handle(name: name, perl: self)
+	}
+}
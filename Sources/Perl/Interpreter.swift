@@ -61,6 +61,13 @@ public struct PerlInterpreter {
 		set { PERL_SET_THX(newValue.pointer) }
 	}
 
+	/// The interpreter bound to the calling thread or `nil` if there is none.
+	/// Used to restore the current interpreter after switching temporarily.
+	static var bound: PerlInterpreter? {
+		get { return getBoundInterpreter().map(PerlInterpreter.init) }
+		set { setBoundInterpreter(newValue?.pointer) }
+	}
+
 	/// The main Perl interpreter of the process.
 	public static var main: PerlInterpreter {
 		get { return PerlInterpreter(PERL_GET_INTERP()) }
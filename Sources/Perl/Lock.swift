@@ -0,0 +1,100 @@
+#if os(Linux) || os(FreeBSD) || os(PS4) || os(Android) || CYGWIN
+import Glibc
+#elseif os(macOS) || os(iOS) || os(watchOS) || os(tvOS)
+import Darwin
+#endif
+
+final class Mutex {
+	fileprivate let mutex = UnsafeMutablePointer<pthread_mutex_t>.allocate(capacity: 1)
+
+	init() {
+		mutex.initialize(to: pthread_mutex_t())
+		pthread_mutex_init(mutex, nil)
+	}
+
+	deinit {
+		pthread_mutex_destroy(mutex)
+		mutex.deinitialize(count: 1)
+		mutex.deallocate()
+	}
+
+	func lock() {
+		pthread_mutex_lock(mutex)
+	}
+
+	func unlock() {
+		pthread_mutex_unlock(mutex)
+	}
+
+	func withLock<R>(_ body: () throws -> R) rethrows -> R {
+		lock()
+		defer { unlock() }
+		return try body()
+	}
+}
+
+final class Condition {
+	private let cond = UnsafeMutablePointer<pthread_cond_t>.allocate(capacity: 1)
+
+	init() {
+		cond.initialize(to: pthread_cond_t())
+		pthread_cond_init(cond, nil)
+	}
+
+	deinit {
+		pthread_cond_destroy(cond)
+		cond.deinitialize(count: 1)
+		cond.deallocate()
+	}
+
+	/// Must be called with `mutex` locked.
+	func wait(_ mutex: Mutex) {
+		pthread_cond_wait(cond, mutex.mutex)
+	}
+
+	func signal() {
+		pthread_cond_signal(cond)
+	}
+
+	func broadcast() {
+		pthread_cond_broadcast(cond)
+	}
+}
+
+final class PosixThread {
+	private final class Context {
+		let body: () -> Void
+		init(_ body: @escaping () -> Void) {
+			self.body = body
+		}
+	}
+
+	private var thread: pthread_t?
+
+	init(_ body: @escaping () -> Void) {
+		let context = Unmanaged.passRetained(Context(body)).toOpaque()
+#if os(Linux) || os(FreeBSD) || os(PS4) || os(Android) || CYGWIN
+		var thread = pthread_t()
+		let status = pthread_create(&thread, nil, {
+			Unmanaged<Context>.fromOpaque($0!).takeRetainedValue().body()
+			return nil
+		}, context)
+#else
+		var thread: pthread_t?
+		let status = pthread_create(&thread, nil, {
+			Unmanaged<Context>.fromOpaque($0).takeRetainedValue().body()
+			return nil
+		}, context)
+#endif
+		precondition(status == 0, "Cannot create thread")
+		self.thread = thread
+	}
+
+	var isCurrent: Bool {
+		return pthread_equal(pthread_self(), thread!) != 0
+	}
+
+	func join() {
+		pthread_join(thread!, nil)
+	}
+}
@@ -0,0 +1,131 @@
+import CPerl
+
+private final class MulticallState {
+	let perl: PerlInterpreter
+	let next: (UnsafeAvContext) -> Bool
+	let result: (UnsafeSvContext) throws -> Bool
+	var error: Error?
+
+	init(perl: PerlInterpreter, next: @escaping (UnsafeAvContext) -> Bool, result: @escaping (UnsafeSvContext) throws -> Bool) {
+		self.perl = perl
+		self.next = next
+		self.result = result
+	}
+
+	static func from(_ info: UnsafeMutableRawPointer?) -> MulticallState {
+		return Unmanaged<MulticallState>.fromOpaque(info!).takeUnretainedValue()
+	}
+}
+
+extension PerlSub {
+	/// Calls the subroutine in scalar context again and again until one
+	/// of the closures returns `false`. `next` fills `@_` of the next call,
+	/// `result` receives the value returned by the call.
+	///
+	/// Pure Perl subroutines are entered once and then only their bodies
+	/// are run for every call using Perl's `MULTICALL` protocol,
+	/// the same way `List::Util` runs its callbacks.
+	func multicall(next: (UnsafeAvContext) -> Bool, result: (UnsafeSvContext) throws -> Bool) throws {
+		try withoutActuallyEscaping(next) { next in
+			try withoutActuallyEscaping(result) { result in
+				try withUnsafeCvContext { cvc in
+					let perl = cvc.perl
+					let state = MulticallState(perl: perl, next: next, result: result)
+					var multicall = CPerlCustomMulticall(
+						cv: cvc.cv,
+						next: { _, args, info in
+							let state = MulticallState.from(info)
+							return state.next(UnsafeAvContext(av: args, perl: state.perl))
+						},
+						result: { _, value, info in
+							let state = MulticallState.from(info)
+							do {
+								return try state.result(UnsafeSvContext(sv: value, perl: state.perl))
+							} catch {
+								state.error = error
+								return false
+							}
+						},
+						info: Unmanaged.passUnretained(state).toOpaque()
+					)
+					perl.enterScope()
+					defer { perl.leaveScope() }
+					// Run by an XSUB called with G_EVAL, so Perl exceptions are caught
+					try withUnsafeMutablePointer(to: &multicall) {
+						let address = perl.pointee.newSViv(Int(bitPattern: $0))
+						_ = try perl.unsafeCall(sv: perl.context.multicallSv(perl: perl), args: CollectionOfOne(address), flags: G_VOID)
+					}
+					withExtendedLifetime(state) {}
+					if let error = state.error {
+						throw error
+					}
+				}
+			}
+		}
+	}
+
+	/// Calls the subroutine once for every batch of arguments.
+	///
+	/// It is much faster than calling the subroutine in a loop: pure Perl
+	/// subroutines are entered only once and then their bodies are run
+	/// for every batch the same way `List::Util` runs its callbacks.
+	/// `@_` is refilled before every call.
+	///
+	/// ```swift
+	/// let lengths: [Int] = try sub.callMany([["a"], ["bb"], ["ccc"]])
+	/// ```
+	///
+	/// - Parameter argumentBatches: Arguments of the calls.
+	/// - Returns: Values returned by the calls made in scalar context
+	///   converted to requested Swift types.
+	public func callMany<R : PerlScalarConvertible>(_ argumentBatches: [[PerlScalarConvertible?]]) throws -> [R] {
+		var results: [R] = []
+		results.reserveCapacity(argumentBatches.count)
+		var batches = argumentBatches.makeIterator()
+		try multicall(
+			next: { args in
+				guard let batch = batches.next() else { return false }
+				args.reserveCapacity(batch.count)
+				for arg in batch {
+					args.append(UnsafeSvContext(sv: arg?._toUnsafeSvPointer(perl: args.perl) ?? args.perl.pointee.newSV(0), perl: args.perl))
+				}
+				return true
+			},
+			result: {
+				results.append(try R(_fromUnsafeSvContextCopy: $0))
+				return true
+			}
+		)
+		return results
+	}
+
+	/// Calls the subroutine once for every element of the sequence passing
+	/// the element as the only argument and passes the returned value to `body`.
+	///
+	/// Like `callMany(_:)` it enters pure Perl subroutines only once.
+	///
+	/// ```swift
+	/// try isValid.forEach(emails) { (valid: Bool) in
+	///		print(valid)
+	/// }
+	/// ```
+	///
+	/// - Parameter values: Arguments of the calls.
+	/// - Parameter body: A closure receiving values returned by the calls
+	///   made in scalar context. Throwing an error stops the iteration.
+	public func forEach<S : Sequence, R : PerlScalarConvertible>(_ values: S, _ body: (R) throws -> Void) throws
+		where S.Element : PerlScalarConvertible {
+		var iterator = values.makeIterator()
+		try multicall(
+			next: { args in
+				guard let value = iterator.next() else { return false }
+				args.append(UnsafeSvContext(sv: value._toUnsafeSvPointer(perl: args.perl), perl: args.perl))
+				return true
+			},
+			result: {
+				try body(try R(_fromUnsafeSvContextCopy: $0))
+				return true
+			}
+		)
+	}
+}
@@ -0,0 +1,91 @@
+import CPerl
+
+/// A struct receiving named arguments of a Swift subroutine
+/// (`foo(from => 'master', timeout => 10)`).
+///
+/// Arguments are stored right into the fields listed in `perlArguments`
+/// without building an intermediate dictionary. Fields of missing
+/// arguments keep their default values, unknown arguments are ignored.
+///
+/// ```swift
+/// struct FetchOptions : PerlNamedArguments {
+///		var from = "master"
+///		var timeout = 0
+///		var depth: Int?
+///
+///		static let perlArguments = PerlSub.ArgumentTable<FetchOptions>()
+///			.field("from", \.from)
+///			.field("timeout", \.timeout)
+///			.field("depth", \.depth)
+/// }
+///
+/// PerlSub(name: "fetch") { (url: String, options: FetchOptions) -> Bool in
+///		...
+/// }
+/// ```
+public protocol PerlNamedArguments {
+	/// Creates arguments with default values.
+	init()
+
+	/// Fields of the struct keyed by names of arguments.
+	static var perlArguments: PerlSub.ArgumentTable<Self> { get }
+}
+
+extension PerlSub {
+	/// Names of arguments of a subroutine and fields of `Arguments`
+	/// they are stored into. See `PerlNamedArguments`.
+	///
+	/// Names are kept encoded, so keys on the Perl stack are matched
+	/// without decoding them into Swift strings.
+	public final class ArgumentTable<Arguments> {
+		private struct Field {
+			let name: [UInt8]
+			let set: (inout Arguments, UnsafeSvContext, Int) throws -> Void
+		}
+
+		private var fields: [Field] = []
+
+		public init() {}
+
+		/// Adds an argument `name` stored into the field at `keyPath`.
+		/// An optional field receives `nil` for an undefined value.
+		public func field<T : PerlSubArgument>(_ name: String, _ keyPath: WritableKeyPath<Arguments, T>) -> ArgumentTable {
+			fields.append(Field(name: Array(name.utf8), set: {
+				$0[keyPath: keyPath] = try T._fromUnsafeArgument($1, at: $2)
+			}))
+			return self
+		}
+
+		private func index(of name: UnsafeRawBufferPointer) -> Int? {
+			for (i, field) in fields.enumerated() where field.name.count == name.count && field.name.elementsEqual(name) {
+				return i
+			}
+			return nil
+		}
+
+		/// Stores `value` found on the stack at position `index`
+		/// into the field of the argument `name`.
+		func set(_ arguments: inout Arguments, name: UnsafeSvContext, value: UnsafeSvContext, at index: Int) throws {
+			var i = name.withUnsafeBytes { index(of: $0) }
+			if i == nil && !SvUTF8(name.sv) && name.withUnsafeBytes({ $0.contains { $0 >= 0x80 } }) {
+				// Non-ASCII names in Latin-1 can only be matched after encoding them in UTF-8
+				i = name.withUnsafeBytes { latin1 -> Int? in
+					var utf8: [UInt8] = []
+					utf8.reserveCapacity(latin1.count * 2)
+					for c in latin1 {
+						if c < 0x80 {
+							utf8.append(c)
+						} else {
+							utf8.append(0xC0 | c >> 6)
+							utf8.append(0x80 | c & 0x3F)
+						}
+					}
+					return utf8.withUnsafeBytes { index(of: $0) }
+				}
+			}
+			if let i = i {
+				try fields[i].set(&arguments, value, index)
+			}
+		}
+	}
+}
@@ -0,0 +1,186 @@
+import CPerl
+
+/// A pool of embedded Perl interpreters.
+///
+/// A single Perl interpreter can be used by only one thread at a time.
+/// To serve requests on several threads concurrently create a pool of
+/// interpreters and check one out for each unit of work. A checked out
+/// interpreter is bound to the calling thread as `PerlInterpreter.current`
+/// until it is checked in back. Then the interpreter which was current
+/// before the checkout is restored.
+///
+/// ```swift
+/// let pool = PerlInterpreterPool(size: 4) { perl in
+///		try perl.require("My::App")
+/// }
+/// // On any worker thread
+/// try pool.withInterpreter { perl in
+///		try perl.call(sub: "My::App::handle", request) as Void
+/// }
+/// ```
+public final class PerlInterpreterPool {
+	/// Usage statistics of a pool.
+	public struct Statistics {
+		/// A number of interpreters in the pool.
+		public let size: Int
+
+		/// A number of interpreters available for checkout.
+		public let idle: Int
+
+		/// The maximal number of simultaneously checked out interpreters.
+		public let peakInUse: Int
+
+		/// A total number of checkouts.
+		public let checkouts: Int
+
+		/// A number of checkouts which had to wait for an interpreter to be checked in.
+		public let contendedCheckouts: Int
+
+		/// A total time in seconds spent by threads waiting for an interpreter.
+		public let waitTime: Double
+	}
+
+	private let interpreters: [PerlInterpreter]
+	private var idle: [PerlInterpreter]
+	private let mutex = Mutex()
+	private let available = Condition()
+	// Interpreters current before checkouts, missing if there were none
+	private var previous: [PerlInterpreter.Pointer: PerlInterpreter] = [:]
+
+	private var peakInUse = 0
+	private var checkouts = 0
+	private var contendedCheckouts = 0
+	private var waitTime: UInt64 = 0
+
+	/// Creates a pool of `size` embedded Perl interpreters.
+	///
+	/// - Parameter size: A number of interpreters to create.
+	/// - Parameter setup: A closure called once for every new interpreter
+	///   to preload modules and do other initialization. The interpreter
+	///   is the current one during the call. The current interpreter
+	///   of the calling thread is restored afterwards.
+	/// - Throws: An error thrown by `setup`. All the interpreters already
+	///   created are destroyed in this case.
+	public init(size: Int, setup: (PerlInterpreter) throws -> Void = { _ in }) rethrows {
+		precondition(size > 0, "Pool size should be positive")
+		var interpreters: [PerlInterpreter] = []
+		interpreters.reserveCapacity(size)
+		let bound = PerlInterpreter.bound
+		defer { PerlInterpreter.bound = bound }
+		do {
+			for _ in 0..<size {
+				let perl = PerlInterpreter.new()
+				interpreters.append(perl)
+				PerlInterpreter.current = perl
+				try setup(perl)
+			}
+		} catch {
+			for perl in interpreters {
+				PerlInterpreter.current = perl
+				perl.destroy()
+			}
+			throw error
+		}
+		self.interpreters = interpreters
+		idle = interpreters
+	}
+
+	/// A number of interpreters in the pool.
+	public var size: Int {
+		return interpreters.count
+	}
+
+	/// Takes an interpreter out of the pool and makes it the current one
+	/// for the calling thread. Blocks until an interpreter is available.
+	///
+	/// Every checked out interpreter must be returned using `checkin(_:)`.
+	public func checkout() -> PerlInterpreter {
+		mutex.lock()
+		checkouts += 1
+		if idle.isEmpty {
+			contendedCheckouts += 1
+			let start = monotonicTime()
+			repeat {
+				available.wait(mutex)
+			} while idle.isEmpty
+			waitTime += monotonicTime() - start
+		}
+		let perl = idle.removeLast()
+		peakInUse = max(peakInUse, interpreters.count - idle.count)
+		previous[perl.pointer] = PerlInterpreter.bound
+		mutex.unlock()
+		PerlInterpreter.current = perl
+		return perl
+	}
+
+	/// Takes an interpreter out of the pool if one is available immediately.
+	public func tryCheckout() -> PerlInterpreter? {
+		mutex.lock()
+		guard let perl = idle.popLast() else {
+			mutex.unlock()
+			return nil
+		}
+		checkouts += 1
+		peakInUse = max(peakInUse, interpreters.count - idle.count)
+		previous[perl.pointer] = PerlInterpreter.bound
+		mutex.unlock()
+		PerlInterpreter.current = perl
+		return perl
+	}
+
+	/// Returns the interpreter previously obtained by `checkout()` to the pool.
+	///
+	/// If the interpreter is still the current one of the calling thread,
+	/// the interpreter which was current before the checkout is restored
+	/// or the thread is left without a current interpreter.
+	public func checkin(_ perl: PerlInterpreter) {
+		mutex.lock()
+		assert(interpreters.contains { $0.pointer == perl.pointer }, "Interpreter does not belong to the pool")
+		assert(!idle.contains { $0.pointer == perl.pointer }, "Interpreter is already checked in")
+		let restored = previous.removeValue(forKey: perl.pointer)
+		// Checkouts made on top of this one restore what preceded it
+		for (other, previousOfOther) in previous where previousOfOther.pointer == perl.pointer {
+			previous[other] = restored
+		}
+		idle.append(perl)
+		mutex.unlock()
+		if PerlInterpreter.bound?.pointer == perl.pointer {
+			PerlInterpreter.bound = restored
+		}
+		available.signal()
+	}
+
+	/// Checks out an interpreter, passes it to `body` and checks it in
+	/// when `body` returns or throws.
+	public func withInterpreter<R>(_ body: (PerlInterpreter) throws -> R) rethrows -> R {
+		let perl = checkout()
+		defer { checkin(perl) }
+		return try body(perl)
+	}
+
+	/// A snapshot of the pool usage statistics.
+	public var statistics: Statistics {
+		return mutex.withLock {
+			return Statistics(size: interpreters.count, idle: idle.count, peakInUse: peakInUse,
+				checkouts: checkouts, contendedCheckouts: contendedCheckouts, waitTime: Double(waitTime) / 1e9)
+		}
+	}
+
+	/// Shuts down all the interpreters of the pool.
+	/// All of them must be checked in.
+	public func destroy() {
+		mutex.lock()
+		precondition(idle.count == interpreters.count, "Cannot destroy pool while interpreters are checked out")
+		idle = []
+		mutex.unlock()
+		var bound = PerlInterpreter.bound
+		for perl in interpreters {
+			if bound?.pointer == perl.pointer {
+				bound = nil
+			}
+			PerlInterpreter.current = perl
+			perl.destroy()
+		}
+		PerlInterpreter.bound = bound
+	}
+}
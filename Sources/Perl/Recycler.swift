@@ -0,0 +1,205 @@
+import CPerl
+
+/// Replaces a long-lived embedded Perl interpreter with a fresh one
+/// when it has served too many requests or has grown too much.
+///
+/// A standby interpreter is created in advance on a background thread,
+/// so a switch to it costs nothing to the serving thread. The retired
+/// interpreter is destroyed on the same background thread.
+///
+/// ```swift
+/// let recycler = PerlInterpreterRecycler(policy: .init(maxRequests: 10_000)) {
+///		let perl = PerlInterpreter.new()
+///		try! perl.require("My::App")
+///		return perl
+/// }
+/// // On the serving thread
+/// while let request = nextRequest() {
+///		try recycler.interpreter.call(sub: "My::App::handle", request) as Void
+///		recycler.requestFinished()
+/// }
+/// recycler.shutdown()
+/// ```
+///
+/// The recycler is meant to be used by one serving thread. It holds two
+/// interpreters most of the time: the current and the standby one.
+public final class PerlInterpreterRecycler {
+	/// Conditions which cause an interpreter to be recycled.
+	/// An interpreter is recycled when any of the limits is reached.
+	public struct Policy {
+		/// The maximal number of requests served by an interpreter.
+		public var maxRequests: Int?
+
+		/// The maximal number of live SVs in an interpreter.
+		public var maxSvCount: Int?
+
+		/// The maximal growth in bytes of the resident set size of the process
+		/// while an interpreter serves requests.
+		///
+		/// The resident set size is measured process-wide, so other threads and
+		/// interpreters count towards it too, and it rarely drops after memory
+		/// is freed. So the growth is counted from a baseline taken after the
+		/// standby interpreter is warmed up and the retired one is destroyed.
+		/// Supported on Linux only.
+		public var maxResidentGrowth: Int?
+
+		public init(maxRequests: Int? = nil, maxSvCount: Int? = nil, maxResidentGrowth: Int? = nil) {
+			self.maxRequests = maxRequests
+			self.maxSvCount = maxSvCount
+			self.maxResidentGrowth = maxResidentGrowth
+		}
+	}
+
+	/// The recycling policy.
+	public let policy: Policy
+
+	/// The interpreter to serve requests with. It is the current
+	/// interpreter of the serving thread.
+	public private(set) var interpreter: PerlInterpreter
+
+	/// A number of requests served by the current interpreter.
+	public private(set) var requests = 0
+
+	/// A number of interpreters recycled so far.
+	public private(set) var recycled = 0
+
+	private let factory: () -> PerlInterpreter
+	private let mutex = Mutex()
+	private let wakeup = Condition()
+	private let ready = Condition()
+	private var standby: PerlInterpreter?
+	private var standbyWanted = true
+	private var retired: [PerlInterpreter] = []
+	private var stopping = false
+	private var thread: PosixThread!
+	private var residentBaseline: Int?
+
+	/// Creates an interpreter to serve requests with and starts preparing
+	/// a standby one in background.
+	///
+	/// - Parameter policy: Conditions which cause an interpreter to be recycled.
+	/// - Parameter factory: A closure creating and warming up interpreters.
+	///   The first interpreter is created on the calling thread, all the
+	///   others are created on the background thread.
+	public init(policy: Policy, factory: @escaping () -> PerlInterpreter = { PerlInterpreter.new() }) {
+		self.policy = policy
+		self.factory = factory
+		interpreter = factory()
+		PerlInterpreter.current = interpreter
+		thread = PosixThread { self.main() }
+	}
+
+	/// Whether the current interpreter has reached any of the policy limits.
+	public var exhausted: Bool {
+		if let max = policy.maxRequests, requests >= max {
+			return true
+		}
+		if let max = policy.maxSvCount, Int(interpreter.pointee.Isv_count) >= max {
+			return true
+		}
+		if let max = policy.maxResidentGrowth, let baseline = residentBaseline, let rss = residentSize(), rss - baseline >= max {
+			return true
+		}
+		return false
+	}
+
+	/// Must be called on the serving thread after every request.
+	///
+	/// Switches to the standby interpreter if the current one is exhausted.
+	/// If the standby interpreter is not ready yet the current one is kept
+	/// until the next request.
+	///
+	/// - Returns: `true` if the interpreter was replaced.
+	@discardableResult
+	public func requestFinished() -> Bool {
+		requests += 1
+		if policy.maxResidentGrowth != nil && residentBaseline == nil && standbyReady {
+			residentBaseline = residentSize()
+		}
+		guard exhausted else { return false }
+		return recycle(waiting: false)
+	}
+
+	/// Whether the background thread has nothing to do: the standby interpreter
+	/// is created and retired ones are destroyed, so the memory they take
+	/// does not change any more.
+	private var standbyReady: Bool {
+		mutex.lock()
+		defer { mutex.unlock() }
+		return standby != nil && retired.isEmpty
+	}
+
+	/// Switches to the standby interpreter unconditionally,
+	/// waiting for it to be created if necessary.
+	public func recycle() {
+		recycle(waiting: true)
+	}
+
+	@discardableResult
+	private func recycle(waiting: Bool) -> Bool {
+		mutex.lock()
+		if waiting {
+			while standby == nil {
+				ready.wait(mutex)
+			}
+		}
+		guard let fresh = standby else {
+			mutex.unlock()
+			return false
+		}
+		standby = nil
+		standbyWanted = true
+		retired.append(interpreter)
+		mutex.unlock()
+		wakeup.signal()
+		interpreter = fresh
+		PerlInterpreter.current = fresh
+		requests = 0
+		recycled += 1
+		residentBaseline = nil
+		return true
+	}
+
+	/// Stops the background thread and destroys all the interpreters.
+	/// The recycler must not be used afterwards.
+	public func shutdown() {
+		mutex.lock()
+		stopping = true
+		mutex.unlock()
+		wakeup.signal()
+		thread.join()
+		PerlInterpreter.current = interpreter
+		interpreter.destroy()
+	}
+
+	private func main() {
+		mutex.lock()
+		while true {
+			if !retired.isEmpty {
+				let perl = retired.removeFirst()
+				mutex.unlock()
+				PerlInterpreter.current = perl
+				perl.destroyQuickly()
+				mutex.lock()
+			} else if stopping {
+				break
+			} else if standbyWanted {
+				standbyWanted = false
+				mutex.unlock()
+				let perl = factory()
+				mutex.lock()
+				standby = perl
+				ready.signal()
+			} else {
+				wakeup.wait(mutex)
+			}
+		}
+		let perl = standby
+		standby = nil
+		mutex.unlock()
+		if let perl = perl {
+			PerlInterpreter.current = perl
+			perl.destroyQuickly()
+		}
+	}
+}
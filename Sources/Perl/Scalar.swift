@@ -76,6 +76,23 @@ public final class PerlScalar : PerlValue {
 		self.init(noincUnchecked: UnsafeSvContext.new(v, utf8: containing == .characters, perl: perl))
 	}
 
+	/// Creates a Perl byte string of at most `capacity` bytes which are
+	/// written by `body` right into the string buffer of the SV.
+	/// `body` returns the number of bytes actually written.
+	///
+	/// Unlike `init(_:containing:perl:)` no intermediate Swift buffer
+	/// is needed, so large encoded blobs are passed to Perl without copying:
+	///
+	/// ```swift
+	/// let blob = try PerlScalar(unsafeUninitializedCapacity: encoder.maxLength) {
+	///		try encoder.encode(value, into: $0)
+	/// }
+	/// ```
+	public convenience init(unsafeUninitializedCapacity capacity: Int, perl: PerlInterpreter = .current, initializingWith body: (UnsafeMutableRawBufferPointer) throws -> Int) rethrows {
+		self.init(perl: perl)
+		try withUnsafeSvContext { try $0.set(unsafeUninitializedCapacity: capacity, initializingWith: body) }
+	}
+
 	/// Creates a new SV which is an exact duplicate of the original SV.
 	public convenience init(copy scalar: PerlScalar) {
 		self.init(noincUnchecked: UnsafeSvContext.new(copy: scalar.unsafeSvContext))
@@ -255,6 +272,14 @@ public final class PerlScalar : PerlValue {
 		withUnsafeSvContext { $0.set(value, containing: containing) }
 	}
 
+	/// Makes `self` a byte string of at most `capacity` bytes which are
+	/// written by `body` right into the string buffer, reusing it if it is
+	/// large enough. `body` returns the number of bytes actually written.
+	/// Does not handle 'set' magic.
+	public func set(unsafeUninitializedCapacity capacity: Int, initializingWith body: (UnsafeMutableRawBufferPointer) throws -> Int) rethrows {
+		try withUnsafeSvContext { try $0.set(unsafeUninitializedCapacity: capacity, initializingWith: body) }
+	}
+
 	/// A textual representation of the SV, suitable for debugging.
 	public override var debugDescription: String {
 		var values = [String]()
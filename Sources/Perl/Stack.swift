@@ -24,9 +24,11 @@ struct UnsafeXSubStack : UnsafeStack {
 	let args: UnsafeStackBufferPointer
 	let perl: PerlInterpreter
 	let ax: Int32
+	let timer: UnsafeMutablePointer<XSubTimer>?
 
-	init(perl: PerlInterpreter) {
+	init(perl: PerlInterpreter, timer: UnsafeMutablePointer<XSubTimer>? = nil) {
 		self.perl = perl
+		self.timer = timer
 		//SV **sp = (my_perl->Istack_sp); I32 ax = (*(my_perl->Imarkstack_ptr)--); SV **mark = (my_perl->Istack_base) + ax++; I32 items = (I32)(sp - mark);
 		var sp = perl.pointee.PL_stack_sp
 		ax = perl.pointee.POPMARK()
@@ -36,12 +38,43 @@ struct UnsafeXSubStack : UnsafeStack {
 		args = UnsafeStackBufferPointer(start: UnsafeMutableRawPointer(sp + 1).assumingMemoryBound(to: UnsafeSvPointer.self), count: items)
 	}
 
+	/// Must be called when all the arguments are converted and the body
+	/// is going to be called. Used to measure time spent on conversions.
+	func bodyStarted() {
+		timer?.pointee.bodyStarted()
+	}
+
+	/// Must be called when the body returns and its result is going to be converted.
+	func bodyFinished() {
+		timer?.pointee.bodyFinished()
+	}
+
 	func xsReturn<C : Collection>(_ result: C)
 		where C.Iterator.Element == UnsafeSvPointer {
 		var sp = perl.pointee.PL_stack_base + Int(ax)
 		pushTo(sp: &sp, from: result)
 	}
 
+	/// Returns a single value from the XSUB without allocation of a new SV
+	/// when possible: booleans are returned as immortal `PL_sv_yes` and
+	/// `PL_sv_no`, other simple values are stored into the target SV
+	/// of the calling op the same way as `dXSTARG` and `PUSHi` do.
+	func xsReturn(scalar value: PerlScalarConvertible?) {
+		let sv: UnsafeSvPointer
+		if let value = value as? Bool {
+			sv = perl.pointee.boolSV(value)
+		} else if let value = value, let targ = perl.pointee.xsTarget(),
+			value._setUnsafeSvContext(UnsafeSvContext(sv: targ, perl: perl)) {
+			sv = targ
+		} else {
+			sv = perl.pointee.sv_2mortal(value?._toUnsafeSvPointer(perl: perl) ?? perl.pointee.newSV(0))!
+		}
+		var sp = perl.pointee.EXTEND(perl.pointee.PL_stack_base + Int(ax), 1)
+		sp += 1
+		sp.initialize(to: sv)
+		perl.pointee.PL_stack_sp = sp
+	}
+
 	subscript(_ i: Int) -> UnsafeSvPointer {
 		guard i < args.count else {
 			return perl.pointee.sv_2mortal(perl.pointee.newSV(0))!
@@ -49,20 +82,8 @@ struct UnsafeXSubStack : UnsafeStack {
 		return args[i]
 	}
 
-	func fetch<T : PerlScalarConvertible>(at index: Int) throws -> T {
-		guard index < args.count else {
-			if T.self == PerlScalar.self {
-				return PerlScalar() as! T
-			} else {
-				throw PerlError.noArgumentOnStack(at: index)
-			}
-		}
-		return try T(_fromUnsafeSvContextCopy: UnsafeSvContext(sv: args[index], perl: perl))
-	}
-
-	func fetch<T : PerlScalarConvertible>(at index: Int) throws -> T? {
-		guard index < args.count else { return nil }
-		return try Optional<T>(_fromUnsafeSvContextCopy: UnsafeSvContext(sv: args[index], perl: perl))
+	func fetch<T : PerlSubArgument>(at index: Int) throws -> T {
+		return try T._fromUnsafeArgument(index < args.count ? UnsafeSvContext(sv: args[index], perl: perl) : nil, at: index)
 	}
 
 #if swift(>=3.2)
@@ -115,24 +136,165 @@ struct UnsafeXSubStack : UnsafeStack {
 		}
 		return tail
 	}
+
+	func fetchNamed<A : PerlNamedArguments>(startingAt index: Int) throws -> A {
+		var arguments = A()
+		guard index < args.count else { return arguments }
+		let table = A.perlArguments
+		guard (args.count - index) % 2 == 0 else { throw PerlError.oddElementsHash }
+		for i in stride(from: index, to: args.count, by: 2) {
+			try table.set(&arguments, name: UnsafeSvContext(sv: args[i], perl: perl), value: UnsafeSvContext(sv: args[i + 1], perl: perl), at: i + 1)
+		}
+		return arguments
+	}
 }
 
 struct UnsafeCallStack : UnsafeStack {
 	let perl: PerlInterpreter
+	private let pool: UnsafeArgumentPool?
+	private let poolMark: Int
 
-	init<C : Collection>(perl: PerlInterpreter, args: C)
+	/// The invocant is pushed as is, all the arguments are mortalized.
+	init<C : Collection>(perl: PerlInterpreter, invocant: UnsafeSvPointer? = nil, args: C)
 		where C.Iterator.Element == UnsafeSvPointer {
 		self.perl = perl
+		pool = nil
+		poolMark = 0
 		var sp = perl.pointee.PL_stack_sp
 		perl.pointee.PUSHMARK(sp)
+		if let invocant = invocant {
+			sp = perl.pointee.EXTEND(sp, 1)
+			sp += 1
+			sp.initialize(to: invocant)
+		}
 		pushTo(sp: &sp, from: args)
 	}
 
+	/// Pushes a mark and extends the stack for `count` arguments, which
+	/// are then converted right onto the stack by `push(_:)`.
+	/// Arguments are stored into SVs of the interpreter's argument pool
+	/// when possible, `releaseArguments()` must be called after the call
+	/// and conversion of its returned values: XSUBs like `List::Util::maxstr`
+	/// return argument SVs as is.
+	init(perl: PerlInterpreter, invocant: UnsafeSvPointer? = nil, reserving count: Int) {
+		self.perl = perl
+		pool = count != 0 ? perl.context.arguments : nil
+		poolMark = pool?.mark ?? 0
+		var sp = perl.pointee.PL_stack_sp
+		perl.pointee.PUSHMARK(sp)
+		sp = perl.pointee.EXTEND(sp, invocant == nil ? count : count + 1)
+		if let invocant = invocant {
+			sp += 1
+			sp.initialize(to: invocant)
+		}
+		perl.pointee.PL_stack_sp = sp
+	}
+
+	/// Must not be called more times than reserved by `init(perl:invocant:reserving:)`.
+	func push<T : PerlScalarConvertible>(_ value: T) {
+		if let pool = pool {
+			let sv = pool.take(perl: perl)
+			if value._setUnsafeSvContext(UnsafeSvContext(sv: sv, perl: perl)) {
+				push(sv)
+				return
+			}
+			pool.putBack()
+		}
+		push(perl.pointee.sv_2mortal(value._toUnsafeSvPointer(perl: perl))!)
+	}
+
+	func push(_ value: PerlScalarConvertible?) {
+		if let pool = pool {
+			let sv = pool.take(perl: perl)
+			if let value = value {
+				if value._setUnsafeSvContext(UnsafeSvContext(sv: sv, perl: perl)) {
+					push(sv)
+					return
+				}
+				pool.putBack()
+			} else {
+				perl.pointee.setUndef(sv)
+				push(sv)
+				return
+			}
+		}
+		push(perl.pointee.sv_2mortal(value?._toUnsafeSvPointer(perl: perl) ?? perl.pointee.newSV(0))!)
+	}
+
+	private func push(_ sv: UnsafeSvPointer) {
+		let sp = perl.pointee.PL_stack_sp + 1
+		sp.initialize(to: sv)
+		perl.pointee.PL_stack_sp = sp
+	}
+
+	/// Returns argument SVs taken from the pool back to it. Arguments still
+	/// referenced by the callee are left to it.
+	func releaseArguments() {
+		pool?.release(from: poolMark, perl: perl)
+	}
+
 	func popReturned(count: Int) -> UnsafeStackBufferPointer {
 		return perl.popFromStack(count: count)
 	}
 }
 
+/// SVs reused as arguments of calls made by an interpreter.
+///
+/// Taken SVs are lent to callees without mortalization and are checked
+/// after the call. Only those which nobody else references and which were
+/// not turned into something special by the callee are reused. The rest
+/// are released and so belong to the callee from then on.
+final class UnsafeArgumentPool {
+	/// The maximal number of idle SVs kept by the pool.
+	static let capacity = 64
+
+	/// SVs with larger string buffers are not kept by the pool.
+	static let maxBufferLength = 4096
+
+	private var idle: [UnsafeSvPointer] = []
+	private var lent: [UnsafeSvPointer] = []
+
+	init() {
+		idle.reserveCapacity(UnsafeArgumentPool.capacity)
+	}
+
+	/// A position to release lent SVs from. Calls are nested,
+	/// so SVs are released in the reverse order.
+	var mark: Int {
+		return lent.count
+	}
+
+	func take(perl: PerlInterpreter) -> UnsafeSvPointer {
+		let sv = idle.popLast() ?? perl.pointee.newSV(0)
+		lent.append(sv)
+		return sv
+	}
+
+	/// Returns the SV taken last without using it.
+	func putBack() {
+		idle.append(lent.removeLast())
+	}
+
+	func release(from mark: Int, perl: PerlInterpreter) {
+		while lent.count > mark {
+			let sv = lent.removeLast()
+			if idle.count < UnsafeArgumentPool.capacity && isReusableArgument(sv, UnsafeArgumentPool.maxBufferLength) {
+				idle.append(sv)
+			} else {
+				perl.pointee.SvREFCNT_dec_NN(sv)
+			}
+		}
+	}
+
+	func free(perl: PerlInterpreter) {
+		release(from: 0, perl: perl)
+		for sv in idle {
+			perl.pointee.SvREFCNT_dec_NN(sv)
+		}
+		idle = []
+	}
+}
+
 extension PerlInterpreter {
 	func popFromStack(count: Int) -> UnsafeStackBufferPointer {
 		var sp = pointee.PL_stack_sp
@@ -0,0 +1,347 @@
+import CPerl
+
+/// A process-wide counter of live objects of some kind.
+struct LiveCounter {
+	private let pointer: UnsafeMutablePointer<Int>
+
+	init() {
+		pointer = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+		pointer.initialize(to: 0)
+	}
+
+	func increment() {
+		_ = atomicAddInt(pointer, 1)
+	}
+
+	func decrement() {
+		_ = atomicAddInt(pointer, -1)
+	}
+
+	var value: Int {
+		return atomicLoadInt(pointer)
+	}
+}
+
+enum LiveCounters {
+	static let values = LiveCounter()
+	static let bridgedObjects = LiveCounter()
+	static let subroutines = LiveCounter()
+}
+
+extension PerlInterpreter {
+	/// A snapshot of memory usage of an interpreter.
+	public struct Statistics {
+		/// Usage of one of the interpreter's internal stacks.
+		public struct StackUsage {
+			/// A number of entries currently in use.
+			public let depth: Int
+
+			/// A number of entries allocated. Perl never shrinks its stacks,
+			/// so it is at least the deepest the stack has ever been, but
+			/// it includes the initial allocation and growth increments
+			/// and is not the exact peak depth.
+			public let capacity: Int
+		}
+
+		/// A number of live SVs (`PL_sv_count`).
+		public let svCount: Int
+
+		/// A number of allocated SV arenas.
+		public let svArenas: Int
+
+		/// A total number of SV slots in all the arenas, both used and free.
+		public let svArenaSlots: Int
+
+		/// The argument stack.
+		public let argumentStack: StackUsage
+
+		/// The stack of mortal SVs.
+		public let tmpsStack: StackUsage
+
+		/// The stack of argument stack marks.
+		public let markStack: StackUsage
+
+		/// The stack of values to be restored on scope exit.
+		public let saveStack: StackUsage
+
+		/// A number of live `PerlValue` instances in the process or `nil`
+		/// unless `PerlValue.countsLiveInstances` is enabled.
+		public let liveValues: Int?
+
+		/// A number of Swift objects bridged to Perl and referenced
+		/// by Perl SVs in the process.
+		public let liveBridgedObjects: Int
+
+		/// A number of live Perl subroutines implemented in Swift in the process.
+		public let liveSubroutines: Int
+	}
+
+	/// Takes a snapshot of memory usage statistics.
+	///
+	/// Sampling walks the list of SV arenas (one arena per about a hundred
+	/// SVs) and reads a few interpreter variables, so it is cheap enough
+	/// to be done per request. The counters of live wrappers are process-wide
+	/// and are shared by all the interpreters.
+	public var statistics: Statistics {
+		var arenas = 0
+		var slots = 0
+		var arena = pointee.Isv_arenaroot
+		while let a = arena {
+			arenas += 1
+			// The first SV of an arena holds its size in the reference counter
+			// and a pointer to the next arena in the body pointer.
+			slots += Int(a.pointee.sv_refcnt)
+			arena = a.pointee.sv_any?.assumingMemoryBound(to: SV.self)
+		}
+		let p = pointer
+		return Statistics(
+			svCount: Int(p.pointee.Isv_count),
+			svArenas: arenas,
+			svArenaSlots: slots,
+			argumentStack: Statistics.StackUsage(depth: p.pointee.Istack_sp! - p.pointee.Istack_base!,
+				capacity: p.pointee.Istack_max! - p.pointee.Istack_base! + 1),
+			tmpsStack: Statistics.StackUsage(depth: p.pointee.Itmps_ix + 1, capacity: p.pointee.Itmps_max),
+			markStack: Statistics.StackUsage(depth: p.pointee.Imarkstack_ptr! - p.pointee.Imarkstack!,
+				capacity: p.pointee.Imarkstack_max! - p.pointee.Imarkstack!),
+			saveStack: Statistics.StackUsage(depth: Int(p.pointee.Isavestack_ix), capacity: Int(p.pointee.Isavestack_max)),
+			liveValues: PerlValue.countsLiveInstances ? LiveCounters.values.value : nil,
+			liveBridgedObjects: LiveCounters.bridgedObjects.value,
+			liveSubroutines: LiveCounters.subroutines.value
+		)
+	}
+}
+
+/// Counters of calls of Swift subroutines with the same name.
+///
+/// Clones of an interpreter share bodies of subroutines with the original
+/// one, so the counters can be updated by several threads and are
+/// updated atomically.
+final class XSubCounters {
+	/// A number of buckets of time histograms. The upper bound of
+	/// the bucket `i` is 2^i microseconds, the last bucket is unbounded.
+	static let bucketCount = 24
+
+	private static let calls = 0
+	private static let exceptions = 1
+	private static let wallTime = 2
+	private static let cpuTime = 3
+	private static let conversionTime = 4
+	private static let wallHistogram = 5
+	private static let cpuHistogram = wallHistogram + bucketCount
+	private static let slotCount = cpuHistogram + bucketCount
+
+	let name: String
+	private let slots: UnsafeMutablePointer<Int>
+
+	private init(name: String) {
+		self.name = name
+		slots = UnsafeMutablePointer<Int>.allocate(capacity: XSubCounters.slotCount)
+		slots.initialize(repeating: 0, count: XSubCounters.slotCount)
+	}
+
+	private static let mutex = Mutex()
+	private static var registry: [String: XSubCounters] = [:]
+
+	/// Returns the counters shared by all the subroutines with the name.
+	/// The counters are never freed.
+	static func named(_ name: String) -> XSubCounters {
+		return mutex.withLock {
+			if let counters = registry[name] {
+				return counters
+			}
+			let counters = XSubCounters(name: name)
+			registry[name] = counters
+			return counters
+		}
+	}
+
+	static var all: [XSubCounters] {
+		return mutex.withLock { Array(registry.values) }
+	}
+
+	private static func bucket(_ nanoseconds: UInt64) -> Int {
+		let microseconds = nanoseconds / 1000
+		return min(64 - microseconds.leadingZeroBitCount, bucketCount - 1)
+	}
+
+	func record(wallTime: UInt64, cpuTime: UInt64, conversionTime: UInt64, failed: Bool) {
+		_ = atomicAddInt(slots + XSubCounters.calls, 1)
+		if failed {
+			_ = atomicAddInt(slots + XSubCounters.exceptions, 1)
+		}
+		_ = atomicAddInt(slots + XSubCounters.wallTime, Int(wallTime))
+		_ = atomicAddInt(slots + XSubCounters.cpuTime, Int(cpuTime))
+		_ = atomicAddInt(slots + XSubCounters.conversionTime, Int(conversionTime))
+		_ = atomicAddInt(slots + XSubCounters.wallHistogram + XSubCounters.bucket(wallTime), 1)
+		_ = atomicAddInt(slots + XSubCounters.cpuHistogram + XSubCounters.bucket(cpuTime), 1)
+	}
+
+	func reset() {
+		for i in 0..<XSubCounters.slotCount {
+			atomicStoreInt(slots + i, 0)
+		}
+	}
+
+	var statistics: PerlSub.Statistics {
+		func load(_ slot: Int) -> Int {
+			return atomicLoadInt(slots + slot)
+		}
+		func histogram(_ first: Int) -> [Int] {
+			return (first..<first + XSubCounters.bucketCount).map(load)
+		}
+		return PerlSub.Statistics(
+			calls: load(XSubCounters.calls),
+			exceptions: load(XSubCounters.exceptions),
+			wallTime: Double(load(XSubCounters.wallTime)) / 1e9,
+			cpuTime: Double(load(XSubCounters.cpuTime)) / 1e9,
+			conversionTime: Double(load(XSubCounters.conversionTime)) / 1e9,
+			wallTimeHistogram: histogram(XSubCounters.wallHistogram),
+			cpuTimeHistogram: histogram(XSubCounters.cpuHistogram)
+		)
+	}
+}
+
+/// Measures a single call of a Swift subroutine.
+struct XSubTimer {
+	private let counters: XSubCounters
+	private let start: UInt64
+	private let cpuStart: UInt64
+	private var bodyStart: UInt64 = 0
+	private var bodyFinish: UInt64 = 0
+
+	init(counters: XSubCounters) {
+		self.counters = counters
+		start = monotonicTime()
+		cpuStart = threadCPUTime()
+	}
+
+	mutating func bodyStarted() {
+		bodyStart = monotonicTime()
+	}
+
+	mutating func bodyFinished() {
+		bodyFinish = monotonicTime()
+	}
+
+	func finish(failed: Bool) {
+		let finish = monotonicTime()
+		let cpuTime = threadCPUTime() - cpuStart
+		var conversionTime: UInt64 = 0
+		if bodyStart != 0 {
+			conversionTime = bodyStart - start
+			if bodyFinish != 0 {
+				conversionTime += finish - bodyFinish
+			}
+		}
+		counters.record(wallTime: finish - start, cpuTime: cpuTime, conversionTime: conversionTime, failed: failed)
+	}
+}
+
+extension PerlSub {
+	/// Statistics of calls of a Swift subroutine.
+	///
+	/// Times are measured for whole calls including conversions of arguments
+	/// and return values. For subroutines with typed bodies the time spent
+	/// on the conversions is also reported separately.
+	public struct Statistics {
+		/// A number of calls.
+		public let calls: Int
+
+		/// A number of calls which threw an error.
+		public let exceptions: Int
+
+		/// The total wall clock time of the calls in seconds.
+		public let wallTime: Double
+
+		/// The total CPU time of the calls in seconds.
+		public let cpuTime: Double
+
+		/// The total time spent on conversions of arguments
+		/// and return values in seconds.
+		public let conversionTime: Double
+
+		/// Numbers of calls by their wall clock time.
+		/// See `histogramBounds` for the bounds of the buckets.
+		public let wallTimeHistogram: [Int]
+
+		/// Numbers of calls by their CPU time.
+		/// See `histogramBounds` for the bounds of the buckets.
+		public let cpuTimeHistogram: [Int]
+
+		/// Upper bounds of the buckets of the histograms in seconds:
+		/// 1µs, 2µs, 4µs and so on. The last bucket is unbounded.
+		public static let histogramBounds: [Double] = (0..<XSubCounters.bucketCount).map {
+			$0 == XSubCounters.bucketCount - 1 ? Double.infinity : Double(1 << $0) / 1e6
+		}
+	}
+
+	/// Whether Swift subroutines created afterwards collect statistics
+	/// of their calls. Disabled by default. When it is disabled a call
+	/// costs only a check of a pointer.
+	///
+	/// Every interpreter with such subroutines also gets Perl subroutines
+	/// `Swift::Stats::dump()`, which returns a reference to a hash of
+	/// statistics keyed by names of subroutines, and `Swift::Stats::reset()`.
+	///
+	/// The setting is process-wide and is meant to be changed on startup.
+	public static var collectsStatistics = false
+
+	/// Statistics of calls of the subroutine or `nil` if it is not a Swift
+	/// subroutine created while `collectsStatistics` was enabled.
+	///
+	/// Subroutines with the same name share statistics, as well as anonymous
+	/// subroutines created in the same file.
+	public var statistics: Statistics? {
+		return withUnsafeCvContext { $0.swiftBody?.counters?.statistics }
+	}
+
+	/// Statistics of all the Swift subroutines collecting them keyed by
+	/// their names.
+	public static var allStatistics: [String: Statistics] {
+		var all: [String: Statistics] = [:]
+		for counters in XSubCounters.all {
+			all[counters.name] = counters.statistics
+		}
+		return all
+	}
+
+	/// Resets statistics of all the Swift subroutines.
+	public static func resetStatistics() {
+		for counters in XSubCounters.all {
+			counters.reset()
+		}
+	}
+}
+
+extension PerlInterpreter {
+	/// Defines `Swift::Stats::dump()` and `Swift::Stats::reset()` once.
+	func defineStatisticsSubs() {
+		let context = self.context
+		guard !context.statisticsSubsDefined else { return }
+		context.statisticsSubsDefined = true
+		guard getCV("Swift::Stats::dump") == nil else { return }
+		PerlSub(name: "Swift::Stats::dump", perl: self) {
+			(stack: UnsafeXSubStack) in
+			let perl = stack.perl
+			let all = PerlHash(perl: perl)
+			for (name, statistics) in PerlSub.allStatistics {
+				let item: [String: PerlScalar] = [
+					"calls": PerlScalar(statistics.calls, perl: perl),
+					"exceptions": PerlScalar(statistics.exceptions, perl: perl),
+					"wall_time": PerlScalar(statistics.wallTime, perl: perl),
+					"cpu_time": PerlScalar(statistics.cpuTime, perl: perl),
+					"conversion_time": PerlScalar(statistics.conversionTime, perl: perl),
+					"wall_histogram": PerlScalar(statistics.wallTimeHistogram, perl: perl),
+					"cpu_histogram": PerlScalar(statistics.cpuTimeHistogram, perl: perl),
+				]
+				all[name] = PerlScalar(item, perl: perl)
+			}
+			stack.xsReturn(CollectionOfOne(PerlScalar(all)._toUnsafeSvPointer(perl: perl)))
+		}
+		PerlSub(name: "Swift::Stats::reset", perl: self) {
+			(stack: UnsafeXSubStack) in
+			PerlSub.resetStatistics()
+			stack.xsReturn(EmptyCollection())
+		}
+	}
+}
@@ -0,0 +1,174 @@
+import CPerl
+
+/// A read-only view of a Perl string which keeps its bytes in the `SV`.
+///
+/// Conversion of a Perl string to `String` copies and decodes all its bytes.
+/// `PerlString` instead references a private copy of the `SV`, which shares
+/// the string buffer with the original one thanks to Perl's copy-on-write
+/// and stealing of temporary buffers. So large strings cross into Swift
+/// without copying and are converted to `String` only when needed:
+///
+/// ```swift
+/// PerlSub(name: "checksum") { (payload: PerlString) -> Int in
+///		return payload.withUTF8 { crc32($0) }
+/// }
+/// ```
+///
+/// Perl strings without the `SvUTF8` flag which contain non-ASCII
+/// characters are upgraded to UTF-8 (and so copied) when the view
+/// is created. So the view always contains UTF-8 and strings equal
+/// in Perl are equal regardless of their internal representation.
+/// Passing `PerlString` back to Perl does not copy the buffer either.
+public struct PerlString {
+	private let scalar: PerlScalar
+	private let buffer: UnsafeBufferPointer<UInt8>
+
+	private init(snapshot svc: UnsafeSvContext) {
+		scalar = PerlScalar(noincUnchecked: svc)
+		buffer = svc.withUnsafeBytes { UnsafeBufferPointer($0.bindMemory(to: UInt8.self)) }
+	}
+
+	init(_ svc: UnsafeSvContext) throws {
+		// Copying calls get-magic, so flags of tied scalars are checked on the copy
+		let copy = UnsafeSvContext.new(stealingCopy: svc)
+		guard !SvROK(copy.sv) && (SvPOK(copy.sv) || SvNOK(copy.sv) || SvIOK(copy.sv)) else {
+			copy.refcntDec()
+			throw PerlError.notStringOrNumber(fromUnsafeSvContext(inc: svc))
+		}
+		// Every byte of a non-UTF-8 string is a character, so "caf\xe9"
+		// has to be upgraded to be equal to "café"
+		if !SvUTF8(copy.sv) && !copy.withUnsafeBytes({ isASCII($0.baseAddress!.assumingMemoryBound(to: CChar.self), $0.count) }) {
+			copy.perl.pointee.sv_utf8_upgrade(copy.sv)
+		}
+		self.init(snapshot: copy)
+	}
+
+	/// Creates a Perl string containing `string`.
+	public init(_ string: String, perl: PerlInterpreter = .current) {
+		self.init(snapshot: UnsafeSvContext(sv: perl.newSV(string), perl: perl))
+	}
+
+	/// Creates a view of the string contained in `scalar`.
+	/// Throws if `scalar` does not contain a string or a number.
+	///
+	/// Modifications of `scalar` made afterwards are not visible
+	/// through the view.
+	public init(_ scalar: PerlScalar) throws {
+		try self.init(scalar.unsafeSvContext)
+		_fixLifetime(scalar)
+	}
+
+	/// The number of UTF-8 code units (bytes) in the string.
+	public var count: Int {
+		return buffer.count
+	}
+
+	public var isEmpty: Bool {
+		return buffer.isEmpty
+	}
+
+	/// UTF-8 code units of the string.
+	public var utf8: UTF8View {
+		return UTF8View(string: self)
+	}
+
+	/// Calls `body` with a buffer of UTF-8 code units of the string.
+	/// The buffer must not be used after `body` returns.
+	public func withUTF8<R>(_ body: (UnsafeBufferPointer<UInt8>) throws -> R) rethrows -> R {
+		defer { _fixLifetime(scalar) }
+		return try body(buffer)
+	}
+
+	public func hasPrefix(_ prefix: String) -> Bool {
+		return withUTF8 { $0.starts(with: prefix.utf8) }
+	}
+
+	public func hasSuffix(_ suffix: String) -> Bool {
+		let suffix = suffix.utf8
+		return withUTF8 { $0.count >= suffix.count && $0.suffix(suffix.count).elementsEqual(suffix) }
+	}
+
+	/// A collection of UTF-8 code units of `PerlString`.
+	public struct UTF8View : RandomAccessCollection {
+		fileprivate let string: PerlString
+
+		public var startIndex: Int { return 0 }
+		public var endIndex: Int { return string.buffer.count }
+
+		public subscript(i: Int) -> UInt8 {
+			return string.withUTF8 { $0[i] }
+		}
+
+		public func withContiguousStorageIfAvailable<R>(_ body: (UnsafeBufferPointer<UInt8>) throws -> R) rethrows -> R? {
+			return try string.withUTF8(body)
+		}
+	}
+}
+
+extension PerlString : PerlScalarConvertible {
+	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws {
+		try self.init(svc)
+	}
+
+	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer {
+		return scalar.withUnsafeSvContext { UnsafeSvContext.new(stealingCopy: $0).sv }
+	}
+
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool {
+		scalar.withUnsafeSvContext { svc.set($0.sv) }
+		return true
+	}
+}
+
+extension PerlString : Hashable, Comparable {
+	public static func == (lhs: PerlString, rhs: PerlString) -> Bool {
+		return lhs.withUTF8 { l in rhs.withUTF8 { r in l.elementsEqual(r) } }
+	}
+
+	/// Strings are ordered by their UTF-8 code units,
+	/// which is the same as ordering by Unicode code points.
+	public static func < (lhs: PerlString, rhs: PerlString) -> Bool {
+		return lhs.withUTF8 { l in rhs.withUTF8 { r in l.lexicographicallyPrecedes(r) } }
+	}
+
+	public func hash(into hasher: inout Hasher) {
+		withUTF8 { hasher.combine(bytes: UnsafeRawBufferPointer($0)) }
+	}
+
+	public static func == (lhs: PerlString, rhs: String) -> Bool {
+		return lhs.withUTF8 { $0.elementsEqual(rhs.utf8) }
+	}
+
+	public static func == (lhs: String, rhs: PerlString) -> Bool {
+		return rhs == lhs
+	}
+
+	public static func != (lhs: PerlString, rhs: String) -> Bool {
+		return !(lhs == rhs)
+	}
+
+	public static func != (lhs: String, rhs: PerlString) -> Bool {
+		return !(rhs == lhs)
+	}
+}
+
+extension PerlString : CustomStringConvertible, CustomDebugStringConvertible {
+	public var description: String {
+		return String(self)
+	}
+
+	public var debugDescription: String {
+		return "PerlString(\(String(self).debugDescription))"
+	}
+}
+
+extension String {
+	/// Creates a string from UTF-8 code units of `PerlString`.
+	///
+	/// ```swift
+	/// let s = String(try PerlString(PerlScalar("OK")))   // s == "OK"
+	/// ```
+	public init(_ string: PerlString) {
+		self = string.withUTF8 { String(decoding: $0, as: UTF8.self) }
+	}
+}
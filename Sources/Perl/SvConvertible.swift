@@ -1,38 +1,106 @@
-public protocol PerlScalarConvertible {
+/// A type of an element of a tuple returned from a Perl subroutine.
+///
+/// All the `PerlScalarConvertible` types are such and so are optionals
+/// of them, so every element of a tuple can be optional on its own:
+/// `(Int, String?, Double)`.
+public protocol PerlTupleElement {
+	init(_fromUnsafeSvContextCopy: UnsafeSvContext) throws
+}
+
+/// A type of a parameter of a Swift subroutine.
+///
+/// All the `PerlScalarConvertible` types are such and so are optionals
+/// of them, which receive `nil` for undefined and missing arguments.
+public protocol PerlSubArgument {
+	static func _fromUnsafeArgument(_ svc: UnsafeSvContext?, at index: Int) throws -> Self
+}
+
+public protocol PerlScalarConvertible : PerlTupleElement, PerlSubArgument {
 	init(_fromUnsafeSvContextInc: UnsafeSvContext) throws
 	init(_fromUnsafeSvContextCopy: UnsafeSvContext) throws
 	func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer
+	func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool
 }
 
 extension PerlScalarConvertible {
 	public init(_fromUnsafeSvContextCopy svc: UnsafeSvContext) throws {
 		try self.init(_fromUnsafeSvContextInc: svc)
 	}
+
+	/// Converts the argument of a Swift subroutine at position `index`.
+	/// `svc` is `nil` if the argument is missing.
+	public static func _fromUnsafeArgument(_ svc: UnsafeSvContext?, at index: Int) throws -> Self {
+		guard let svc = svc else {
+			throw PerlError.noArgumentOnStack(at: index)
+		}
+		return try Self(_fromUnsafeSvContextCopy: svc)
+	}
+
+	/// Stores the value into an existing SV. Returns `false` if the value
+	/// cannot be stored without creation of a new SV.
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { return false }
 }
 
 extension Bool : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) { self.init(svc) }
 	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer { return perl.newSV(self) }
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { svc.set(self); return true }
 }
 
 extension Int : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws { try self.init(svc) }
 	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer { return perl.pointee.newSViv(self) }
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { svc.set(self); return true }
 }
 
 extension UInt : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws { try self.init(svc) }
 	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer { return perl.pointee.newSVuv(self) }
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { svc.set(self); return true }
 }
 
 extension Double : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws { try self.init(svc) }
 	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer { return perl.pointee.newSVnv(self) }
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { svc.set(self); return true }
 }
 
 extension String : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws { try self.init(svc) }
 	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer { return perl.newSV(self) }
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool { svc.set(self); return true }
+}
+
+/// Byte arrays are converted to Perl byte strings and vice versa.
+/// Character strings are converted to their UTF-8 representation.
+extension Array : PerlScalarConvertible where Element == UInt8 {
+	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws {
+		self = try svc.withUnsafeBytesOfString { Array($0) }
+	}
+
+	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer {
+		return withUnsafeBytes { UnsafeSvContext.new($0, perl: perl).sv }
+	}
+
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool {
+		withUnsafeBytes { svc.set($0) }
+		return true
+	}
+}
+
+extension ContiguousArray : PerlScalarConvertible where Element == UInt8 {
+	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws {
+		self = try svc.withUnsafeBytesOfString { ContiguousArray($0) }
+	}
+
+	public func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer {
+		return withUnsafeBytes { UnsafeSvContext.new($0, perl: perl).sv }
+	}
+
+	public func _setUnsafeSvContext(_ svc: UnsafeSvContext) -> Bool {
+		withUnsafeBytes { svc.set($0) }
+		return true
+	}
 }
 
 extension PerlScalar : PerlScalarConvertible {
@@ -48,6 +116,12 @@ extension PerlScalar : PerlScalarConvertible {
 		defer { _fixLifetime(self) }
 		return unsafeSvContext.refcntInc()
 	}
+
+	/// A missing argument is converted to an undefined scalar.
+	public static func _fromUnsafeArgument(_ svc: UnsafeSvContext?, at index: Int) throws -> PerlScalar {
+		guard let svc = svc else { return PerlScalar() }
+		return try PerlScalar(_fromUnsafeSvContextCopy: svc)
+	}
 }
 
 extension PerlArray : PerlScalarConvertible {
@@ -96,7 +170,7 @@ extension PerlScalarConvertible where Self : PerlBridgedObject {
 	}
 }
 
-extension Optional where Wrapped : PerlScalarConvertible {
+extension Optional : PerlTupleElement where Wrapped : PerlScalarConvertible {
 	public init(_fromUnsafeSvContextInc svc: UnsafeSvContext) throws {
 		self = svc.defined ? .some(try Wrapped(_fromUnsafeSvContextInc: svc)) : .none
 	}
@@ -115,6 +189,13 @@ extension Optional where Wrapped : PerlScalarConvertible {
 	}
 }
 
+extension Optional : PerlSubArgument where Wrapped : PerlScalarConvertible {
+	public static func _fromUnsafeArgument(_ svc: UnsafeSvContext?, at index: Int) throws -> Optional {
+		guard let svc = svc else { return nil }
+		return try Optional(_fromUnsafeSvContextCopy: svc)
+	}
+}
+
 extension Array where Element : PerlScalarConvertible {
 	func _toUnsafeSvPointer(perl: PerlInterpreter) -> UnsafeSvPointer {
 		let avc = UnsafeAvContext.new(perl: perl)
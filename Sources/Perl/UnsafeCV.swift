@@ -3,12 +3,34 @@ import CPerl
 public typealias UnsafeCvPointer = UnsafeMutablePointer<CV>
 
 typealias CvBody = (UnsafeXSubStack) throws -> Void
-typealias UnsafeCvBodyPointer = UnsafeMutablePointer<CvBody>
 
-extension CV {
-	fileprivate var bodyPointer: UnsafeCvBodyPointer {
-		mutating get { return CvXSUBANY(&self).pointee.any_ptr.assumingMemoryBound(to: CvBody.self) }
-		mutating set { CvXSUBANY(&self).pointee.any_ptr = UnsafeMutableRawPointer(newValue) }
+/// A part of a body of a Swift XSUB independent of its signature.
+class UnsafeCvBodyBase {
+	/// Counters of calls if the XSUB collects statistics.
+	let counters: XSubCounters?
+
+	init(counters: XSubCounters?) {
+		self.counters = counters
+	}
+}
+
+/// A body of a Swift XSUB: either a `CvBody` closure called by `cvResolver`
+/// or a closure of a concrete signature called by a trampoline specialized
+/// for it. The body is referenced both from `CvXSUBANY`, for a fast access
+/// on a call, and from the magic of the CV, which manages its lifetime.
+/// A clone of the CV made by `perl_clone()` shares the body.
+final class UnsafeCvBody<F> : UnsafeCvBodyBase {
+	let function: F
+
+	init(_ function: F, counters: XSubCounters?) {
+		self.function = function
+		super.init(counters: counters)
+	}
+}
+
+extension MAGIC {
+	fileprivate var body: Unmanaged<AnyObject> {
+		return Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(mg_ptr!))
 	}
 }
 
@@ -23,30 +45,63 @@ struct UnsafeCvContext {
 		svt_clear: nil,
 		svt_free: {
 			(perl, sv, magic) in
-			let bodyPointer = UnsafeMutableRawPointer(sv!).assumingMemoryBound(to: CV.self).pointee.bodyPointer
-			bodyPointer.deinitialize(count: 1)
-			bodyPointer.deallocate()
+			magic.unsafelyUnwrapped.pointee.body.release()
+			LiveCounters.subroutines.decrement()
 			return 0
 		},
 		svt_copy: nil,
-		svt_dup: nil,
+		svt_dup: {
+			(perl, magic, param) in
+			// Called by perl_clone(): the clone shares the body, which is
+			// immutable, and `CvXSUBANY` of the clone points to it as well.
+			_ = magic.unsafelyUnwrapped.pointee.body.retain()
+			LiveCounters.subroutines.increment()
+			return 0
+		},
 		svt_local: nil
 	)
 
 	static func new(name: String? = nil, file: StaticString = #file, body: @escaping CvBody, perl: PerlInterpreter) -> UnsafeCvContext {
+		return new(name: name, file: file, function: body, entry: cvResolver, perl: perl)
+	}
+
+	/// Creates an XSUB entered through `entry`, which fetches `function`
+	/// using `unsafeBody(as:)`.
+	static func new<F>(name: String? = nil, file: StaticString = #file, function: F, entry: XSUBADDR_t, perl: PerlInterpreter) -> UnsafeCvContext {
 		func newXS(_ name: UnsafePointer<CChar>?) -> UnsafeCvPointer {
-			return perl.pointee.newXS_flags(name, cvResolver, file.description, nil, UInt32(XS_DYNAMIC_FILENAME))
+			return perl.pointee.newXS_flags(name, entry, file.description, nil, UInt32(XS_DYNAMIC_FILENAME))
 		}
 		let cv = name?.withCString(newXS) ?? newXS(nil)
+		var counters: XSubCounters?
+		if PerlSub.collectsStatistics {
+			counters = XSubCounters.named(name ?? "__ANON__ at \(file)")
+			perl.defineStatisticsSubs()
+		}
+		let body = Unmanaged<AnyObject>.passRetained(UnsafeCvBody(function, counters: counters)).toOpaque()
+		CvXSUBANY(cv).pointee.any_ptr = body
 		cv.withMemoryRebound(to: SV.self, capacity: 1) {
-			_ = perl.pointee.sv_magicext($0, nil, PERL_MAGIC_ext, &mgvtbl, nil, 0)
+			let magic = perl.pointee.sv_magicext($0, nil, PERL_MAGIC_ext, &mgvtbl, body.assumingMemoryBound(to: CChar.self), 0)
+			magic.pointee.mg_flags |= UInt8(MGf_DUP)
 		}
-		let bodyPointer = UnsafeCvBodyPointer.allocate(capacity: 1)
-		bodyPointer.initialize(to: body)
-		cv.pointee.bodyPointer = bodyPointer
+		LiveCounters.subroutines.increment()
 		return UnsafeCvContext(cv: cv, perl: perl)
 	}
 
+	/// Returns the body of an XSUB created by `new(name:file:function:entry:perl:)`.
+	/// `F` must be exactly the type of the function passed there.
+	func unsafeBody<F>(as type: F.Type) -> UnsafeCvBody<F> {
+		let body = Unmanaged<AnyObject>.fromOpaque(CvXSUBANY(cv).pointee.any_ptr!).takeUnretainedValue()
+		return unsafeDowncast(body, to: UnsafeCvBody<F>.self)
+	}
+
+	/// The body of the CV if it is a Swift XSUB.
+	var swiftBody: UnsafeCvBodyBase? {
+		return cv.withMemoryRebound(to: SV.self, capacity: 1) {
+			guard let magic = perl.pointee.mg_findext($0, PERL_MAGIC_ext, &UnsafeCvContext.mgvtbl) else { return nil }
+			return magic.pointee.body.takeUnretainedValue() as? UnsafeCvBodyBase
+		}
+	}
+
 	var name: String? {
 		guard let gv = perl.pointee.CvGV(cv) else { return nil }
 		return String(cString: GvNAME(gv))
@@ -83,26 +138,54 @@ private func cvResolver(perl: PerlInterpreter.Pointer, cv: UnsafeCvPointer) -> V
 	let perl = PerlInterpreter(perl)
 	let errsv: UnsafeSvPointer?
 	do {
-		let stack = UnsafeXSubStack(perl: perl)
-		try cv.pointee.bodyPointer.pointee(stack)
+		let body = UnsafeCvContext(cv: cv, perl: perl).unsafeBody(as: CvBody.self)
+		errsv = unsafeRunXSub(cv: cv, perl: perl, counters: body.counters, body.function)
+	}
+	if let e = errsv {
+		perl.pointee.croak_sv(e)
+		// croak_sv() function never returns. It unwinds stack instead.
+		// No memory managment SIL operations should exist after it.
+		// Check it using --emit-sil if modification of this function required.
+	}
+}
+
+/// Runs a body of an XSUB timing it if the XSUB collects statistics.
+/// Returns a mortal SV to croak with if the body throws.
+@inline(__always)
+func unsafeRunXSub(cv: UnsafeCvPointer, perl: PerlInterpreter, counters: XSubCounters?, _ body: (UnsafeXSubStack) throws -> Void) -> UnsafeSvPointer? {
+	guard let counters = counters else {
+		do {
+			try body(UnsafeXSubStack(perl: perl))
+			return nil
+		} catch {
+			return unsafeXSubError(error, cv: cv, perl: perl)
+		}
+	}
+	var timer = XSubTimer(counters: counters)
+	let errsv: UnsafeSvPointer?
+	do {
+		try withUnsafeMutablePointer(to: &timer) { try body(UnsafeXSubStack(perl: perl, timer: $0)) }
 		errsv = nil
-	} catch PerlError.died(let scalar) {
-		errsv = scalar.withUnsafeSvContext { UnsafeSvContext.new(copy: $0).mortal() }
-	} catch let error as PerlScalarConvertible {
-		let usv = error._toUnsafeSvPointer(perl: perl)
-		errsv = perl.pointee.sv_2mortal(usv)
 	} catch {
-		errsv = "\(error)".withCString { error in
+		errsv = unsafeXSubError(error, cv: cv, perl: perl)
+	}
+	timer.finish(failed: errsv != nil)
+	return errsv
+}
+
+/// Converts an error thrown by a body of an XSUB to a mortal SV to croak with.
+func unsafeXSubError(_ error: Error, cv: UnsafeCvPointer, perl: PerlInterpreter) -> UnsafeSvPointer {
+	if case PerlError.died(let scalar) = error {
+		return scalar.withUnsafeSvContext { UnsafeSvContext.new(copy: $0).mortal() }
+	} else if let error = error as? PerlScalarConvertible {
+		let usv = error._toUnsafeSvPointer(perl: perl)
+		return perl.pointee.sv_2mortal(usv)!
+	} else {
+		return "\(error)".withCString { error in
 			let name = UnsafeCvContext(cv: cv, perl: perl).fullname ?? "__ANON__"
 			return name.withCString { name in
 				withVaList([name, error]) { perl.pointee.vmess("Exception in %s: %s", unsafeBitCast($0, to: UnsafeMutablePointer.self)) }
 			}
 		}
 	}
-	if let e = errsv {
-		perl.pointee.croak_sv(e)
-		// croak_sv() function never returns. It unwinds stack instead.
-		// No memory managment SIL operations should exist after it.
-		// Check it using --emit-sil if modification of this function required.
-	}
 }
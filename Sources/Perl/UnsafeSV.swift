@@ -43,6 +43,19 @@ public struct UnsafeSvContext {
 		return try body(bytes)
 	}
 
+	/// Like `withUnsafeBytes(_:)`, but throws if the SV contains
+	/// neither a string nor a number.
+	func withUnsafeBytesOfString<R>(_ body: (UnsafeRawBufferPointer) throws -> R) throws -> R {
+		return try withUnsafeBytes {
+			// Stringifying an integer sets only the private POK flag,
+			// so check for any defined non-reference value instead.
+			guard SvOK(sv) && !SvROK(sv) else {
+				throw PerlError.notStringOrNumber(fromUnsafeSvContext(inc: self))
+			}
+			return try body($0)
+		}
+	}
+
 	var isObject: Bool { return perl.pointee.sv_isobject(sv) }
 
 	func isDerived(from: String) -> Bool {
@@ -120,11 +133,10 @@ public struct UnsafeSvContext {
 	}
 
 	func set(_ value: String) {
-		let count = value.count
-		value.withCStringWithLength {
+		value.withCStringCheckingASCII {
 			perl.pointee.sv_setpvn(sv, $0, $1)
 
-			if $1 == count {
+			if $2 {
 				SvUTF8_off(sv)
 			} else {
 				SvUTF8_on(sv)
@@ -140,6 +152,16 @@ public struct UnsafeSvContext {
 		}
 	}
 
+	/// Makes the SV a byte string written by `body` right into its buffer
+	/// of `capacity` bytes. `body` returns the number of bytes written.
+	func set(unsafeUninitializedCapacity capacity: Int, initializingWith body: (UnsafeMutableRawBufferPointer) throws -> Int) rethrows {
+		let buffer = UnsafeMutableRawBufferPointer(start: perl.pointee.prepareBuffer(sv, capacity), count: capacity)
+		var count = 0
+		defer { setBufferLength(sv, count) }
+		count = try body(buffer)
+		precondition(count >= 0 && count <= capacity, "Number of written bytes is out of buffer bounds")
+	}
+
 	var hash: UInt32 {
 		return perl.pointee.SvHASH(sv)
 	}
@@ -159,9 +181,8 @@ extension PerlInterpreter {
 	}
 
 	func newSV(_ v: String, mortal: Bool = false) -> UnsafeSvPointer {
-		let count = v.count
-		return v.withCStringWithLength {
-			let flags = ($1 == count ? 0 : SVf_UTF8) | (mortal ? SVs_TEMP : 0)
+		return v.withCStringCheckingASCII {
+			let flags = ($2 ? 0 : SVf_UTF8) | (mortal ? SVs_TEMP : 0)
 			return pointee.newSVpvn_flags($0, $1, UInt32(flags))
 		}
 	}
@@ -170,7 +191,10 @@ extension PerlInterpreter {
 		let u = Unmanaged<AnyObject>.passRetained(v)
 		let iv = unsafeBitCast(u, to: Int.self)
 		let sv = pointee.sv_setref_iv(pointee.newSV(0), isa, iv)
-		pointee.sv_magicext(SvRV(sv)!, nil, PERL_MAGIC_ext, &objectMgvtbl, nil, 0)
+		// The object is also referenced from `mg_ptr` to make it accessible from `svt_dup`.
+		let magic = pointee.sv_magicext(SvRV(sv)!, nil, PERL_MAGIC_ext, &objectMgvtbl, u.toOpaque().assumingMemoryBound(to: CChar.self), 0)
+		magic.pointee.mg_flags |= UInt8(MGf_DUP)
+		LiveCounters.bridgedObjects.increment()
 		return sv
 	}
 
@@ -186,13 +210,20 @@ private var objectMgvtbl = MGVTBL(
 	svt_clear: nil,
 	svt_free: {
 		(perl, sv, magic) in
-		let iv = perl.unsafelyUnwrapped.pointee.SvIV(sv.unsafelyUnwrapped)
-		let u = Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(bitPattern: iv)!)
+		let u = Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(magic.unsafelyUnwrapped.pointee.mg_ptr!))
 		u.release()
+		LiveCounters.bridgedObjects.decrement()
 		return 0
 	},
 	svt_copy: nil,
-	svt_dup: nil,
+	svt_dup: {
+		(perl, magic, param) in
+		// Called by perl_clone(): the cloned SV holds its own reference to the same Swift object.
+		let u = Unmanaged<AnyObject>.fromOpaque(UnsafeRawPointer(magic.unsafelyUnwrapped.pointee.mg_ptr!))
+		_ = u.retain()
+		LiveCounters.bridgedObjects.increment()
+		return 0
+	},
 	svt_local: nil
 )
 
@@ -1,3 +1,9 @@
+#if os(Linux) || os(FreeBSD) || os(PS4) || os(Android) || CYGWIN
+import Glibc
+#elseif os(macOS) || os(iOS) || os(watchOS) || os(tvOS)
+import Darwin
+#endif
+
 func isStrictSubclass(_ child: AnyClass, of parent: AnyClass) -> Bool {
 	var cur: AnyClass = child
 	while let next = _getSuperclass(cur) {
@@ -8,3 +14,35 @@ func isStrictSubclass(_ child: AnyClass, of parent: AnyClass) -> Bool {
 	}
 	return false
 }
+
+/// Monotonic time in nanoseconds.
+func monotonicTime() -> UInt64 {
+	var ts = timespec()
+	clock_gettime(CLOCK_MONOTONIC, &ts)
+	return UInt64(ts.tv_sec) * 1_000_000_000 + UInt64(ts.tv_nsec)
+}
+
+/// CPU time consumed by the calling thread in nanoseconds.
+func threadCPUTime() -> UInt64 {
+	var ts = timespec()
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)
+	return UInt64(ts.tv_sec) * 1_000_000_000 + UInt64(ts.tv_nsec)
+}
+
+/// Resident set size of the process in bytes or `nil` if it is unknown.
+func residentSize() -> Int? {
+#if os(Linux)
+	// The second field of /proc/self/statm is the number of resident pages.
+	let fd = open("/proc/self/statm", O_RDONLY)
+	guard fd >= 0 else { return nil }
+	defer { close(fd) }
+	var buffer = [UInt8](repeating: 0, count: 128)
+	let count = buffer.withUnsafeMutableBytes { read(fd, $0.baseAddress, $0.count) }
+	guard count > 0 else { return nil }
+	let fields = buffer[0..<count].split(separator: UInt8(ascii: " "))
+	guard fields.count > 1, let pages = Int(String(decoding: fields[1], as: UTF8.self)) else { return nil }
+	return pages * sysconf(Int32(_SC_PAGESIZE))
+#else
+	return nil
+#endif
+}
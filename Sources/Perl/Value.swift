@@ -10,6 +10,9 @@ open class PerlValue : AnyPerl, CustomDebugStringConvertible {
 	/// Performs no type checks and should be used only if compatibility is known.
 	public required init(noincUnchecked svc: UnsafeSvContext) {
 		unsafeSvContext = svc
+		if PerlValue.countsLiveInstances {
+			LiveCounters.values.increment()
+		}
 	}
 
 	/// Unsafely creates an instance incrementing a reference counter of a SV.
@@ -17,6 +20,9 @@ open class PerlValue : AnyPerl, CustomDebugStringConvertible {
 	public required init(incUnchecked svc: UnsafeSvContext) {
 		svc.refcntInc()
 		unsafeSvContext = svc
+		if PerlValue.countsLiveInstances {
+			LiveCounters.values.increment()
+		}
 	}
 
 	/// Unsafely creates an instance without incrementing a reference counter of a SV.
@@ -43,8 +49,20 @@ open class PerlValue : AnyPerl, CustomDebugStringConvertible {
 
 	deinit {
 		unsafeSvContext.refcntDec()
+		if PerlValue.countsLiveInstances {
+			LiveCounters.values.decrement()
+		}
 	}
 
+	/// Whether live instances of `PerlValue` are counted for
+	/// `PerlInterpreter.statistics`. Disabled by default, because the counter
+	/// is process-wide and updated atomically on every creation and
+	/// destruction of an instance.
+	///
+	/// The setting is process-wide and is meant to be changed on startup,
+	/// before any instances are created.
+	public static var countsLiveInstances = false
+
 	/// Invokes the given closure on the unsafe context containing pointers
 	/// to the SV and the Perl interpreter.
 	///
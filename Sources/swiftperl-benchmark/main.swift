@@ -19,6 +19,16 @@ final class TestBridgedObject : PerlBridgedObject {
 	static let perlClassName = "TestBridgedObject"
 }
 
+struct NamedInt : PerlNamedArguments {
+	var k = 0
+	static let perlArguments = PerlSub.ArgumentTable<NamedInt>().field("k", \.k)
+}
+
+struct NamedString : PerlNamedArguments {
+	var k = ""
+	static let perlArguments = PerlSub.ArgumentTable<NamedString>().field("k", \.k)
+}
+
 let perl = PerlInterpreter.new()
 defer { perl.destroy() }
 
@@ -29,8 +39,12 @@ let subobj: TestObject = try! perl.eval("bless {}, 'TestObject'")
 PerlSub(name: "void") { () -> Void in }
 
 PerlSub(name: "in_int") { (_: Int) -> Void in }
+PerlSub(name: "in_int_op") { (_: Int) -> Void in }.registerCustomOp()
 PerlSub(name: "in_string") { (_: String) -> Void in }
+PerlSub(name: "in_perlstring") { (_: PerlString) -> Void in }
+PerlSub(name: "in_bytes") { (_: [UInt8]) -> Void in }
 PerlSub(name: "in_scalar") { (_: PerlScalar) -> Void in }
+PerlSub(name: "in_borrowed_scalar") { (_: PerlSub.Borrowed<PerlScalar>) -> Void in }
 PerlSub(name: "in_object") { (_: PerlObject) -> Void in }
 PerlSub(name: "in_subobject") { (_: TestObject) -> Void in }
 PerlSub(name: "in_bridged_object") { (_: TestBridgedObject) -> Void in }
@@ -42,9 +56,23 @@ PerlSub(name: "in_arrscalar") { (_: [PerlScalar]) -> Void in }
 PerlSub(name: "in_dictint") { (_: [String: Int]) -> Void in }
 PerlSub(name: "in_dictstring") { (_: [String: String]) -> Void in }
 PerlSub(name: "in_dictscalar") { (_: [String: PerlScalar]) -> Void in }
+PerlSub(name: "in_namedint") { (_: NamedInt) -> Void in }
+PerlSub(name: "in_namedstring") { (_: NamedString) -> Void in }
 
 PerlSub(name: "out_int") { () -> Int in 10 }
 PerlSub(name: "out_string") { () -> String in "string" }
+let longASCII = String(repeating: "ascii-string", count: 100)
+let longUnicode = longASCII + "строченька"
+PerlSub(name: "out_longstring") { () -> String in longASCII }
+PerlSub(name: "out_longunicode") { () -> String in longUnicode }
+let longBytes = [UInt8](longASCII.utf8)
+PerlSub(name: "out_bytes") { () -> [UInt8] in longBytes }
+PerlSub(name: "out_blob") { () -> PerlScalar in
+	PerlScalar(unsafeUninitializedCapacity: longBytes.count) { buffer in
+		longBytes.withUnsafeBytes { buffer.copyMemory(from: $0) }
+		return longBytes.count
+	}
+}
 PerlSub(name: "out_scalar") { () -> PerlScalar in PerlScalar() }
 PerlSub(name: "out_object") { () -> PerlObject in obj }
 PerlSub(name: "out_subobject") { () -> TestObject in subobj }
@@ -71,9 +99,15 @@ PerlSub(name: "lr_out_bridged_object") { _ in [TestBridgedObject()] }
 run("void()")
 
 run("in_int(10)")
+run("in_int_op(10)")
 run("in_string('строченька')")
 run("in_string('ascii-string')")
+run("in_string('ascii-string' x 1000)")
+run("in_perlstring('ascii-string')")
+run("in_perlstring('ascii-string' x 1000)")
+run("in_bytes('ascii-string' x 1000)")
 run("in_scalar(undef)")
+run("in_borrowed_scalar(undef)")
 run("in_object(bless {}, 'TestAnyObject')")
 run("in_subobject(bless {}, 'TestObject')")
 run("in_object(bless {}, 'TestObject')")
@@ -89,8 +123,16 @@ run("in_dictstring(k => 'строченька')")
 run("in_dictstring(k => 'ascii-string')")
 run("in_dictscalar(k => undef)")
 
+run("in_namedint(k => 10)")
+run("in_namedstring(k => 'строченька')")
+run("in_namedstring(k => 'ascii-string')")
+
 run("out_int()")
 run("out_string()")
+run("out_longstring()")
+run("out_longunicode()")
+run("out_bytes()")
+run("out_blob()")
 run("out_scalar()")
 run("out_object()")
 run("out_subobject()")
@@ -117,9 +159,27 @@ run("lr_out_bridged_object()")
 
 try perl.eval("sub nop {}")
 run("nop()") { try! perl.call(sub: "nop") }
+run("nop(10, 'string')") { try! perl.call(sub: "nop", 10, "string") }
+run("nop(args: [10, 'string'])") { try! perl.call(sub: "nop", args: [10, "string"]) }
+
+try perl.eval("sub triple { return (1, 'two', 3) }")
+run("triple() as ReturnValues") { _ = try! perl.call(sub: "triple", context: .array) as PerlSub.ReturnValues }
+run("triple() borrowed") { _ = try! perl.withReturnValues(sub: "triple") { $0.count } }
+
+let nopHandle = perl.resolve("nop")
+run("resolved nop()") { try! nopHandle.call() }
+perl.withScope(freeTempsEvery: 100) { scope in
+	run("scoped resolved nop()") { try! scope.call(sub: nopHandle) }
+}
 
 let nop = PerlSub(get: "nop")!
 run("$nop->()") { try! nop.call() }
+run("$nop->(10, 'string')") { try! nop.call(10, "string") }
+let nopBatch = Array(repeating: [10, "string"] as [PerlScalarConvertible?], count: 1000)
+run("$nop->(10, 'string') x 1000 via callMany", count: 1000) { _ = try! nop.callMany(nopBatch) as [PerlScalar] }
+
+run("eval('1 + 1')", count: 100000) { _ = try! perl.eval("1 + 1") as Int }
+run("compile('1 + 1')->()") { _ = try! perl.compile("1 + 1").call() as Int }
 
 try perl.eval("sub TestObject::nop {}")
 run("TestObject->nop()") { try! TestObject.call(method: "nop") }
@@ -4,6 +4,14 @@ import XCTest
 class CallTests : EmbeddedTestCase {
 	static var allTests = [
 		("testContext", testContext),
+		("testHandle", testHandle),
+		("testArguments", testArguments),
+		("testScope", testScope),
+		("testArgumentPool", testArgumentPool),
+		("testCompile", testCompile),
+		("testMulticall", testMulticall),
+		("testBorrowedReturnValues", testBorrowedReturnValues),
+		("testTupleReturns", testTupleReturns),
 	]
 
 	func testContext() throws {
@@ -33,4 +41,177 @@ class CallTests : EmbeddedTestCase {
 		let a3 = try perl.call(sub: "list3", context: .array)
 		XCTAssertEqual(try a3.map { try String($0) }, ["a", "b"])
 	}
+
+	func testHandle() throws {
+		let handle = perl.resolve("Handle::Test::value")
+		XCTAssertFalse(handle.isDefined)
+		XCTAssertThrowsError(try handle.call() as Int)
+		try perl.eval("sub Handle::Test::value { return 1 + ($_[0] // 0) }")
+		XCTAssertTrue(handle.isDefined)
+		XCTAssertEqual(try handle.call() as Int, 1)
+		XCTAssertEqual(try handle.call(10) as Int, 11)
+		try perl.eval("no warnings 'redefine'; sub Handle::Test::value { return 2 }")
+		XCTAssertEqual(try handle.call() as Int, 2)
+		try perl.eval("no warnings 'redefine'; *Handle::Test::value = sub { return 3 }")
+		XCTAssertEqual(try handle.call() as Int, 3)
+		try perl.eval("delete $Handle::Test::{value}")
+		XCTAssertFalse(handle.isDefined)
+		try perl.eval("sub nop {}")
+		try perl.resolve("nop").call() as Void
+	}
+
+	func testArguments() throws {
+		try perl.eval("sub args { return join ',', map { defined $_ ? $_ : 'undef' } @_ }")
+		XCTAssertEqual(try perl.call(sub: "args", 1) as String, "1")
+		XCTAssertEqual(try perl.call(sub: "args", 1, "two") as String, "1,two")
+		XCTAssertEqual(try perl.call(sub: "args", 1, "two", 3.5) as String, "1,two,3.5")
+		XCTAssertEqual(try perl.call(sub: "args", 1, nil, "three") as String, "1,undef,three")
+		XCTAssertEqual(try perl.call(sub: "args", args: [1, nil]) as String, "1,undef")
+		let sub = PerlSub(get: "args")!
+		XCTAssertEqual(try sub.call(PerlScalar("scalar"), true) as String, "scalar,1")
+		try perl.eval("sub pair { return @_ }")
+		let (a, b): (Int, String) = try perl.call(sub: "pair", 10, "x")
+		XCTAssertEqual(a, 10)
+		XCTAssertEqual(b, "x")
+		try perl.eval("sub ArgsTest::args { shift; return join ',', @_ }")
+		let obj: PerlObject = try perl.eval("bless {}, 'ArgsTest'")
+		XCTAssertEqual(try obj.call(method: "args", 1, 2) as String, "1,2")
+	}
+
+	func testScope() throws {
+		try perl.eval("my $n = 0; sub counter { return ++$n + ($_[0] // 0) }")
+		let handle = perl.resolve("counter")
+		let sum: Int = try perl.withScope(freeTempsEvery: 3) { scope in
+			var sum = 0
+			for i in 0..<10 {
+				sum += try scope.call(sub: "counter") as Int
+				sum += try scope.call(sub: handle, i) as Int
+			}
+			return sum
+		}
+		XCTAssertEqual(sum, (1...20).reduce(0, +) + (0..<10).reduce(0, +))
+		try perl.eval("sub ScopeTest::name { return ref $_[0] }")
+		let obj: PerlObject = try perl.eval("bless {}, 'ScopeTest'")
+		XCTAssertEqual(try perl.withScope { try $0.call(method: "name", args: [obj]) as String }, "ScopeTest")
+		XCTAssertThrowsError(try perl.withScope { try $0.call(sub: "die_in_scope") as Void })
+	}
+
+	func testArgumentPool() throws {
+		try perl.eval("sub args { return join ',', map { defined $_ ? $_ : 'undef' } @_ }")
+		try perl.eval("our @kept; sub keep { push @kept, \\$_[0]; return }")
+		try perl.eval("sub spoil { $_[0] = [1]; Internals::SvREADONLY($_[1], 1); return }")
+		for i in 0..<3 {
+			try perl.call(sub: "keep", i) as Void
+			try perl.call(sub: "spoil", i, "string") as Void
+			XCTAssertEqual(try perl.call(sub: "args", "s\(i)", i) as String, "s\(i),\(i)")
+			XCTAssertEqual(try perl.call(sub: "args", args: [i, nil]) as String, "\(i),undef")
+		}
+		XCTAssertEqual(try perl.eval("join ',', map { $$_ } @kept") as String, "0,1,2")
+		// XSUBs return argument SVs as is, large ones are freed by the pool
+		try perl.require("List::Util")
+		let long = String(repeating: "x", count: 5000)
+		XCTAssertEqual(try perl.call(sub: "List::Util::maxstr", long) as String, long)
+		XCTAssertEqual(try perl.call(sub: "List::Util::maxstr", "s") as PerlScalar, PerlScalar("s"))
+		XCTAssertEqual(try perl.call(sub: "List::Util::maxstr", "t") as String, "t")
+	}
+
+	func testCompile() throws {
+		perl.compileCacheCapacity = 2
+		let double = try perl.compile("return $_[0] * 2")
+		XCTAssertEqual(try double.call(21) as Int, 42)
+		XCTAssertTrue(try perl.compile("return $_[0] * 2") === double)
+		_ = try perl.compile("return 1")
+		_ = try perl.compile("return $_[0] * 2")
+		_ = try perl.compile("return 2")
+		XCTAssertFalse(try perl.compile("return 1") === double)
+		var stats = perl.compileCacheStatistics
+		XCTAssertEqual(stats.count, 2)
+		XCTAssertEqual(stats.hits, 2)
+		XCTAssertEqual(stats.misses, 4)
+		XCTAssertEqual(stats.evictions, 2)
+		XCTAssertThrowsError(try perl.compile("return ("))
+		stats = perl.compileCacheStatistics
+		XCTAssertEqual(stats.misses, 5)
+		XCTAssertEqual(stats.count, 2)
+	}
+
+	func testMulticall() throws {
+		try perl.eval("our @kept; sub mc { push @kept, \\@_ if $_[0] == 2; die \"bad\\n\" if $_[0] < 0; return join ',', @_ }")
+		let sub = PerlSub(get: "mc")!
+		XCTAssertEqual(try sub.callMany([[1], [2, "x"], [3, nil, 4]]) as [String], ["1", "2,x", "3,,4"])
+		XCTAssertEqual(try perl.eval("join ',', map { scalar @$_ } @kept") as String, "2")
+		var results: [String] = []
+		try sub.forEach(1...3) { results.append($0) }
+		XCTAssertEqual(results, ["1", "2", "3"])
+		XCTAssertThrowsError(try sub.callMany([[1], [-1], [3]]) as [String])
+		XCTAssertThrowsError(try sub.forEach([1, 2]) { (_: String) in throw PerlError.noArgumentOnStack(at: 0) })
+		XCTAssertEqual(try sub.callMany([[7]]) as [Int], [7])
+		try perl.require("List::Util")
+		let max = PerlSub(get: "List::Util::max")!
+		XCTAssertEqual(try max.callMany([[1, 5, 3], [2]]) as [Int], [5, 2])
+	}
+
+	func testBorrowedReturnValues() throws {
+		try perl.eval("sub list { return map { \"v$_\" } 1..$_[0] }")
+		let strings: [String] = try perl.withReturnValues(sub: "list", 3) { values in
+			XCTAssertEqual(values.count, 3)
+			return try values.indices.map { try values.get($0) }
+		}
+		XCTAssertEqual(strings, ["v1", "v2", "v3"])
+		// Nested calls growing the stack must not clobber the borrowed values
+		let list = PerlSub(get: "list")!
+		let nested: String = try list.withReturnValues(2) { values in
+			let many: Int = try perl.withReturnValues(sub: "list", 100_000) { $0.count }
+			XCTAssertEqual(many, 100_000)
+			return try values.get(0) as String + (try values.get(1) as String)
+		}
+		XCTAssertEqual(nested, "v1v2")
+		XCTAssertEqual(try perl.withReturnValues(sub: "list", 1) { $0[0] }, PerlScalar("v1"))
+		XCTAssertNil(try perl.withReturnValues(sub: "list", 0) { try $0.get(0) as String? })
+		// Argument SVs returned by XSUBs stay intact until the body returns
+		try perl.require("List::Util")
+		let long = String(repeating: "x", count: 5000)
+		let first: String = try perl.withReturnValues(sub: "List::Util::maxstr", long) { values in
+			XCTAssertEqual(try perl.call(sub: "List::Util::maxstr", "y") as String, "y")
+			return try values.get(0)
+		}
+		XCTAssertEqual(first, long)
+	}
+
+	func testTupleReturns() throws {
+		try perl.eval("sub tuple { return @_ }")
+		let (a, b, c): (Int, String, Double) = try perl.call(sub: "tuple", args: [1, "two", 3.5])
+		XCTAssertEqual(a, 1)
+		XCTAssertEqual(b, "two")
+		XCTAssertEqual(c, 3.5)
+		let t5: (Int, String, Int, String, Int) = try perl.call(sub: "tuple", 1, "2", 3, "4", 5)
+		XCTAssertEqual(t5.3, "4")
+		XCTAssertEqual(t5.4, 5)
+		let t6: (Int, Int, Int, Int, Int, Double) = try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6.5])
+		XCTAssertEqual(t6.5, 6.5)
+		let t7: (Int, Int, Int, Int, Int, Int, String?) = try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6])
+		XCTAssertEqual(t7.5, 6)
+		XCTAssertNil(t7.6)
+		let t8: (Int, Int, Int, Int, Int, Int, Int, Int) = try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6, 7, 8])
+		XCTAssertEqual(t8.0 + t8.7, 9)
+		// Too few values: missing ones are undefined
+		XCTAssertThrowsError(try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6, 7]) as (Int, Int, Int, Int, Int, Int, Int, Int))
+		XCTAssertThrowsError(try perl.call(sub: "tuple", args: [1, 2, 3, 4]) as (Int, Int, Int, Int, Int))
+		// Too many values
+		XCTAssertThrowsError(try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6, 7, 8, 9]) as (Int, Int, Int, Int, Int, Int, Int, Int)) {
+			guard case PerlError.tooManyReturnValues(count: 9, want: 8) = $0 else { return XCTFail() }
+		}
+		XCTAssertThrowsError(try perl.call(sub: "tuple", args: [1, 2, 3, 4, 5, 6]) as (Int, Int, Int, Int, Int))
+		XCTAssertThrowsError(try perl.call(sub: "tuple", 1, 2, 3) as (Int, Int))
+		let (x, y, z): (String, String?, Int?) = try perl.call(sub: "tuple", "x", nil)
+		XCTAssertEqual(x, "x")
+		XCTAssertNil(y)
+		XCTAssertNil(z)
+		XCTAssertThrowsError(try perl.call(sub: "tuple", 1) as (Int, String))
+		let sub = PerlSub(get: "tuple")!
+		let (p, q, r): (Bool, PerlScalar, Int?) = try sub.call(true, "q", 3)
+		XCTAssertTrue(p)
+		XCTAssertEqual(q, PerlScalar("q"))
+		XCTAssertEqual(r, 3)
+	}
 }
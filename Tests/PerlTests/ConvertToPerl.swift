@@ -1,6 +1,19 @@
 import XCTest
 @testable import Perl
 
+struct TestNamedArguments : PerlNamedArguments {
+	var from = "origin"
+	var timeout = 0
+	var depth: Int?
+	var café = false
+
+	static let perlArguments = PerlSub.ArgumentTable<TestNamedArguments>()
+		.field("from", \.from)
+		.field("timeout", \.timeout)
+		.field("depth", \.depth)
+		.field("café", \.café)
+}
+
 class ConvertToPerlTests : EmbeddedTestCase {
 	static var allTests: [(String, (ConvertToPerlTests) -> () throws -> Void)] {
 		return [
@@ -10,10 +23,15 @@ class ConvertToPerlTests : EmbeddedTestCase {
 			("testUInt", testUInt),
 			("testDouble", testDouble),
 			("testString", testString),
+			("testPerlString", testPerlString),
+			("testBytes", testBytes),
 			("testScalarRef", testScalarRef),
 			("testArrayRef", testArrayRef),
 			("testHashRef", testHashRef),
 			("testXSub", testXSub),
+			("testXSubTrampolines", testXSubTrampolines),
+			("testXSubCustomOp", testXSubCustomOp),
+			("testXSubStatistics", testXSubStatistics),
 		]
 	}
 
@@ -96,6 +114,74 @@ class ConvertToPerlTests : EmbeddedTestCase {
 		XCTAssert(try perl.call(sub: "is_ascii_string", s))
 		[UInt8]("строченька".utf8).withUnsafeBytes { s.set($0, containing: .characters) }
 		XCTAssert(try perl.call(sub: "is_utf8_string", s))
+		// Non-ASCII characters far from the start are detected too
+		let long = String(repeating: "ascii string", count: 100)
+		try perl.eval("sub is_long_string { return utf8::is_utf8($_[0]) == $_[1] && $_[0] eq ('ascii string' x 100) . $_[2] }")
+		XCTAssert(try perl.call(sub: "is_long_string", PerlScalar(long), false, ""))
+		XCTAssert(try perl.call(sub: "is_long_string", PerlScalar(long + "é"), true, "é"))
+		s.set(long + "é")
+		XCTAssert(try perl.call(sub: "is_long_string", s, true, "é"))
+		s.set(long)
+		XCTAssert(try perl.call(sub: "is_long_string", s, false, ""))
+	}
+
+	func testPerlString() throws {
+		let scalar = PerlScalar("строченька")
+		let s = try PerlString(scalar)
+		scalar.set("changed")
+		XCTAssert(s == "строченька")
+		XCTAssertEqual(String(s), "строченька")
+		XCTAssertEqual(s.count, "строченька".utf8.count)
+		XCTAssert(s.hasPrefix("стро") && s.hasSuffix("енька"))
+		XCTAssertEqual(try PerlString(PerlScalar(42)), try PerlString(PerlScalar("42")))
+		let latin1: PerlString = try perl.eval("my $s = 'caf' . chr(0xe9); utf8::is_utf8($s) ? undef : $s")
+		XCTAssertEqual(latin1, try PerlString(PerlScalar("café")))
+		XCTAssertEqual(latin1.hashValue, try PerlString(PerlScalar("café")).hashValue)
+		XCTAssert(latin1 == "café")
+		XCTAssert(try PerlString(PerlScalar("cafe")) < latin1)
+		XCTAssertThrowsError(try PerlString(PerlScalar()))
+		XCTAssertThrowsError(try PerlString(PerlScalar(referenceTo: PerlScalar(10))))
+		PerlSub(name: "testperlstring") {
+			(payload: PerlString) -> PerlString in
+			XCTAssertEqual(payload.count, 100000)
+			XCTAssert(payload.utf8.allSatisfy { $0 == UInt8(ascii: "x") })
+			return payload
+		}
+		XCTAssertEqual(try perl.eval("my $s = 'x' x 100000; my $r = testperlstring($s); $r eq $s && !utf8::is_utf8($r) ? 'OK' : 'FAIL'"), "OK")
+		XCTAssertEqual(try perl.eval("testperlstring('x' x 100000) eq 'x' x 100000 ? 'OK' : 'FAIL'"), "OK")
+		try perl.eval("sub is_utf8_string { return utf8::is_utf8($_[0]) && $_[0] eq 'строченька' }")
+		XCTAssert(try perl.call(sub: "is_utf8_string", PerlString("строченька")))
+	}
+
+	func testBytes() throws {
+		let bytes = [UInt8](0...255)
+		try perl.eval("sub is_byte_string { return !utf8::is_utf8($_[0]) && $_[0] eq pack('C256', 0..255) }")
+		XCTAssert(try perl.call(sub: "is_byte_string", bytes))
+		XCTAssert(try perl.call(sub: "is_byte_string", ContiguousArray(bytes)))
+		XCTAssertEqual(try perl.eval("pack('C256', 0..255)") as [UInt8], bytes)
+		XCTAssertEqual(try perl.eval("'строченька'") as ContiguousArray<UInt8>, ContiguousArray("строченька".utf8))
+		XCTAssertEqual(try perl.eval("42") as [UInt8], Array("42".utf8))
+		XCTAssertEqual(try perl.eval("42") as ContiguousArray<UInt8>, ContiguousArray("42".utf8))
+		XCTAssertEqual(try perl.eval("4.5") as [UInt8], Array("4.5".utf8))
+		XCTAssertThrowsError(try perl.eval("undef") as [UInt8])
+		XCTAssertThrowsError(try perl.eval("\\42") as [UInt8])
+		let write: (UnsafeMutableRawBufferPointer) -> Int = {
+			for i in 0...255 {
+				$0[i] = UInt8(i)
+			}
+			return 256
+		}
+		let blob = PerlScalar(unsafeUninitializedCapacity: 1000, initializingWith: write)
+		XCTAssert(try perl.call(sub: "is_byte_string", blob))
+		let s = PerlScalar("строченька")
+		s.set(unsafeUninitializedCapacity: 256, initializingWith: write)
+		XCTAssert(try perl.call(sub: "is_byte_string", s))
+		PerlSub(name: "testbytes") {
+			(data: [UInt8]) -> [UInt8] in
+			return Array(data.reversed())
+		}
+		XCTAssertEqual(try perl.eval("testbytes('abc')"), "cba")
+		XCTAssertThrowsError(try perl.eval("testbytes(undef)") as Void)
 	}
 
 	func testScalarRef() throws {
@@ -144,6 +230,15 @@ class ConvertToPerlTests : EmbeddedTestCase {
 			return a! + (b ?? 15)
 		}
 		XCTAssertEqual(try perl.eval("testxsub2(10, undef) == 25 ? 'OK' : 'FAIL'"), "OK")
+		PerlSub(name: "testxsub8") {
+			(a: Int, b: String?, c: Double, d: Int?, e: Bool, f: String, g: Int?, h: PerlScalar) -> String in
+			XCTAssertNil(b)
+			XCTAssertNil(g)
+			XCTAssertFalse(h.defined)
+			return "\(a) \(c) \(d ?? 0) \(e) \(f)"
+		}
+		XCTAssertEqual(try perl.eval("testxsub8(1, undef, 2.5, 4, 1, 'six')"), "1 2.5 4 true six")
+		XCTAssertThrowsError(try perl.eval("testxsub8(1, undef, 2.5)") as Void)
 
 		PerlSub(name: "testarraytail") {
 			(a: Int, b: Int, extra: [String]) -> Int in
@@ -163,6 +258,16 @@ class ConvertToPerlTests : EmbeddedTestCase {
 		}
 		XCTAssertEqual(try perl.eval("testhashtail(10, 15, from => 'master', timeout => 10) == 25 ? 'OK' : 'FAIL'"), "OK")
 
+		PerlSub(name: "testnamed") {
+			(a: Int, options: TestNamedArguments) -> String in
+			XCTAssertEqual(a, 10)
+			return "\(options.from) \(options.timeout) \(options.depth ?? -1) \(options.café)"
+		}
+		XCTAssertEqual(try perl.eval("testnamed(10, from => 'master', timeout => 10, unknown => 1)"), "master 10 -1 false")
+		XCTAssertEqual(try perl.eval("testnamed(10, depth => 3, \"caf\\x{e9}\" => 1)"), "origin 0 3 true")
+		XCTAssertEqual(try perl.eval("testnamed(10, depth => undef)"), "origin 0 -1 false")
+		XCTAssertThrowsError(try perl.eval("testnamed(10, 'from')") as Void)
+
 		PerlSub(name: "testplain") {
 			(args: [PerlScalar]) -> Int in
 			XCTAssertEqual(try Int(args[0]), 10)
@@ -194,6 +299,15 @@ class ConvertToPerlTests : EmbeddedTestCase {
 		try PerlSub { (arg: PerlScalar) -> Void in
 			arg.withUnsafeSvContext { XCTAssertNotEqual($0.sv, origsv, "Argument SV is not copied") }
 		}.call(orig)
+		try PerlSub { (arg: PerlSub.Borrowed<PerlScalar>) -> Void in
+			arg.value.withUnsafeSvContext { XCTAssertEqual($0.sv, origsv, "Borrowed argument SV is copied") }
+		}.call(orig)
+		PerlSub(name: "testborrowed") {
+			(a: PerlSub.Borrowed<PerlScalar>, b: PerlSub.Borrowed<PerlScalar>) -> String in
+			XCTAssertFalse(b.value.defined)
+			return try String(a.value)
+		}
+		XCTAssertEqual(try perl.eval("testborrowed('ololo')"), "ololo")
 
 		var storedIn: PerlScalar?
 		let storedOut: PerlScalar = 40
@@ -206,4 +320,102 @@ class ConvertToPerlTests : EmbeddedTestCase {
 		XCTAssertEqual(try Int(storedIn!), 10)
 		XCTAssertEqual(try Int(storedOut), 40)
 	}
+
+	func testXSubTrampolines() throws {
+		PerlSub(name: "testrepeat") {
+			(n: Int, s: String) -> String in
+			return String(repeating: s, count: n)
+		}
+		XCTAssertEqual(try perl.eval("testrepeat(3, 'ab')"), "ababab")
+		XCTAssertThrowsError(try perl.eval("testrepeat(3)") as Void)
+
+		PerlSub(name: "testhalf") {
+			(d: Double) -> Double in
+			return d / 2
+		}
+		XCTAssertEqual(try perl.eval("testhalf(5)"), 2.5)
+
+		PerlSub(name: "testnot") {
+			(b: Bool) -> Bool in
+			return !b
+		}
+		XCTAssertEqual(try perl.eval("testnot(0) ? 'OK' : 'FAIL'"), "OK")
+		XCTAssertEqual(try perl.eval("my $b = testnot(1); $b = 'mutable'; $b"), "mutable")
+
+		var counter = 0
+		PerlSub(name: "testcounter") {
+			() -> Int in
+			counter += 1
+			return counter
+		}
+		XCTAssertEqual(try perl.eval("join ',', map { testcounter() } 1..3"), "1,2,3")
+		XCTAssertEqual(try perl.eval("my @a; push @a, testcounter() for 1..2; join ',', @a"), "4,5")
+
+		var called = 0
+		PerlSub(name: "testvoid") {
+			() -> Void in
+			called += 1
+		}
+		try perl.eval("testvoid(); testvoid()")
+		XCTAssertEqual(called, 2)
+
+		PerlSub(name: "testthrow") {
+			(s: String) throws -> Int in
+			throw PerlError.died(PerlScalar("thrown \(s)"))
+		}
+		XCTAssertThrowsError(try perl.eval("testthrow('up')") as Void) {
+			guard case PerlError.died(let e) = $0 else { return XCTFail() }
+			XCTAssertEqual(try? String(e), "thrown up")
+		}
+	}
+
+	func testXSubCustomOp() throws {
+		var calls = 0
+		PerlSub(name: "testop") {
+			(a: Int, b: Int) throws -> Int in
+			calls += 1
+			guard a >= 0 else { throw PerlError.died(PerlScalar("negative")) }
+			return a + b
+		}.registerCustomOp()
+		XCTAssertEqual(try perl.eval("my $s = 0; $s += testop($_, 1) for 1..10; $s"), 65)
+		XCTAssertEqual(try perl.eval("testop(testop(1, 2), testop(3, 4))"), 10)
+		XCTAssertEqual(try perl.eval("my @a = (testop(1, 1), testop(2, 2)); qq{@a}"), "2 4")
+		XCTAssertEqual(calls, 15)
+		XCTAssertThrowsError(try perl.eval("testop(-1, 0)") as Void)
+		XCTAssertThrowsError(try perl.eval("testop(1, 1) = 5; 1") as Void)
+		XCTAssertEqual(try perl.eval("sub testopmod { $_[0] = 9 } testopmod(testop(1, 1)); testop(1, 1)"), 2)
+		// Pad temporaries passed as arguments are copied like pp_entersub does
+		var kept: [PerlScalar] = []
+		PerlSub(name: "testopkeep") {
+			(s: PerlSub.Borrowed<PerlScalar>) -> Void in
+			kept.append(s.value)
+		}.registerCustomOp()
+		try perl.eval("testopkeep('k' . $_) for 1..3")
+		XCTAssertEqual(try kept.map { try String($0) }, ["k1", "k2", "k3"])
+		try perl.eval("sub testopcaller { testop(1, 1) } no warnings 'redefine'; eval 'sub testop { 42 }'")
+		XCTAssertEqual(try perl.call(sub: "testopcaller") as Int, 42)
+	}
+
+	func testXSubStatistics() throws {
+		let plain = PerlSub(name: "teststatsoff") { (a: Int) -> Int in a }
+		PerlSub.collectsStatistics = true
+		defer { PerlSub.collectsStatistics = false }
+		let sub = PerlSub(name: "teststats") {
+			(a: Int, b: String) -> String in
+			guard a >= 0 else { throw PerlError.died(PerlScalar("negative")) }
+			return b
+		}
+		XCTAssertNil(plain.statistics)
+		try perl.eval("teststats($_, 'x') for 1..5; eval { teststats(-1, 'x') }; eval { teststats() }")
+		let statistics = sub.statistics!
+		XCTAssertEqual(statistics.calls, 7)
+		XCTAssertEqual(statistics.exceptions, 2)
+		XCTAssertEqual(statistics.wallTimeHistogram.reduce(0, +), 7)
+		XCTAssertEqual(statistics.wallTimeHistogram.count, PerlSub.Statistics.histogramBounds.count)
+		XCTAssertGreaterThan(statistics.wallTime, 0)
+		XCTAssertLessThanOrEqual(statistics.conversionTime, statistics.wallTime)
+		XCTAssertEqual(try perl.eval("Swift::Stats::dump()->{teststats}{calls}"), 7)
+		try perl.eval("Swift::Stats::reset()")
+		XCTAssertEqual(sub.statistics!.calls, 0)
+	}
 }
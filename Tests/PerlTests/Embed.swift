@@ -1,4 +1,5 @@
 import XCTest
+import Dispatch
 import Perl
 
 class EmbedTests: XCTestCase {
@@ -9,12 +10,183 @@ class EmbedTests: XCTestCase {
 		let ok: String = try perl.eval("'OK'")
 		XCTAssertEqual(ok, "OK")
 	}
+
+	func testOptions() throws {
+		let host = PerlInterpreter.new()
+		PerlInterpreter.current = host
+		var timing = PerlInterpreter.StartupTiming()
+		let perl = try PerlInterpreter.new(options: PerlInterpreter.Options(includePaths: ["/nonexistent"], preload: ["List::Util=sum"], switches: ["-w"]), timing: &timing)
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		XCTAssertGreaterThan(timing.parse, 0)
+		XCTAssertEqual(timing.total, timing.construct + timing.parse + timing.run)
+		XCTAssertThrowsError(try PerlInterpreter.new(options: PerlInterpreter.Options(preload: ["No::Such::Module"]))) {
+			guard case PerlError.startupFailed(let status, let message) = $0 else { return XCTFail() }
+			XCTAssertNotEqual(status, 0)
+			XCTAssert(message.contains("Can't locate No/Such/Module.pm"), message)
+		}
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		XCTAssertThrowsError(try PerlInterpreter.new(options: PerlInterpreter.Options(switches: ["-e", "BEGIN { die qq{boom\\n} }"]))) {
+			guard case PerlError.startupFailed(_, let message) = $0 else { return XCTFail() }
+			XCTAssert(message.hasPrefix("boom\n"), message)
+		}
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		XCTAssertThrowsError(try PerlInterpreter.new(options: PerlInterpreter.Options(switches: ["-Z"]))) {
+			guard case PerlError.startupFailed(let status, let message) = $0 else { return XCTFail() }
+			XCTAssert(message.contains("\(status)"), message)
+		}
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		host.destroy()
+		PerlInterpreter.current = perl
+		defer { perl.destroy() }
+		XCTAssertEqual(try perl.eval("sum(1, 2, 3)") as Int, 6)
+		XCTAssertEqual(try perl.eval("$INC[0]") as String, "/nonexistent")
+		XCTAssertTrue(try perl.eval("$^W") as Bool)
+	}
+
+	func testClone() throws {
+		let perl = PerlInterpreter.new()
+		PerlInterpreter.current = perl
+		try perl.eval("sub plus { $_[0] + $_[1] }")
+		PerlSub(name: "mul") { (a: Int, b: Int) -> Int in a * b }
+		TestRefCnt.createPerlMethod("new") { (cname: String) -> TestRefCnt in return TestRefCnt() }
+		try perl.eval("our $obj = TestRefCnt->new()")
+		XCTAssertEqual(TestRefCnt.refcnt, 1)
+		let clone = perl.clone()
+		XCTAssertEqual(PerlInterpreter.current.pointer, perl.pointer)
+		let other = PerlInterpreter.new()
+		PerlInterpreter.current = other
+		let second = perl.clone()
+		XCTAssertEqual(PerlInterpreter.current.pointer, other.pointer)
+		other.destroy()
+		PerlInterpreter.current = second
+		XCTAssertEqual(try second.eval("plus(2, 3)") as Int, 5)
+		second.destroy()
+		PerlInterpreter.current = perl
+		perl.destroy()
+		XCTAssertEqual(TestRefCnt.refcnt, 1)
+		PerlInterpreter.current = clone
+		XCTAssertEqual(try clone.eval("plus(2, 3)") as Int, 5)
+		XCTAssertEqual(try clone.eval("mul(2, 3)") as Int, 6)
+		XCTAssertEqual(try clone.eval("ref $obj") as String, "TestRefCnt")
+		clone.destroy()
+		XCTAssertEqual(TestRefCnt.refcnt, 0)
+	}
+
+	func testPool() throws {
+		let host = PerlInterpreter.new()
+		defer { host.destroy() }
+		PerlInterpreter.current = host
+		let pool = try PerlInterpreterPool(size: 2) { perl in
+			try perl.eval("our $id = int(rand(1_000_000_000))")
+		}
+		defer { pool.destroy() }
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		let first = pool.checkout()
+		let second = pool.checkout()
+		XCTAssertNil(pool.tryCheckout())
+		XCTAssertNotEqual(first.pointer, second.pointer)
+		XCTAssertEqual(PerlInterpreter.current.pointer, second.pointer)
+		try first.eval("$main::x = 'first'")
+		try second.eval("$main::x = 'second'")
+		XCTAssertEqual(try first.eval("$main::x") as String, "first")
+		XCTAssertEqual(try second.eval("$main::x") as String, "second")
+		pool.checkin(first)
+		pool.checkin(second)
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		let ok: String = try pool.withInterpreter { try $0.eval("'OK'") }
+		XCTAssertEqual(ok, "OK")
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		let stat = pool.statistics
+		XCTAssertEqual(stat.size, 2)
+		XCTAssertEqual(stat.idle, 2)
+		XCTAssertEqual(stat.peakInUse, 2)
+		XCTAssertEqual(stat.checkouts, 3)
+		XCTAssertEqual(stat.contendedCheckouts, 0)
+	}
+
+	func testExecutor() throws {
+		let host = PerlInterpreter.new()
+		defer { host.destroy() }
+		PerlInterpreter.current = host
+		let executor = PerlExecutor(batchSize: 16)
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		executor.submit { perl in
+			try! perl.eval("our @seen; sub seen { push @seen, $_[0] }")
+		}
+		DispatchQueue.concurrentPerform(iterations: 4) { thread in
+			for i in 0..<100 {
+				executor.submit { perl in
+					try! perl.call(sub: "seen", thread * 100 + i) as Void
+				}
+			}
+		}
+		var count = 0
+		var sorted = false
+		executor.submit { perl in
+			count = try! perl.eval("scalar @seen")
+			sorted = try! perl.eval("join(',', sort { $a <=> $b } @seen) eq join(',', 0..399)")
+		}
+		XCTAssertFalse(executor.isShutDown)
+		executor.shutdown()
+		XCTAssertTrue(executor.isShutDown)
+		XCTAssertEqual(PerlInterpreter.current.pointer, host.pointer)
+		XCTAssertEqual(count, 400)
+		XCTAssertTrue(sorted)
+	}
+
+	func testStatistics() throws {
+		let perl = PerlInterpreter.new()
+		defer { perl.destroy() }
+		PerlInterpreter.current = perl
+		XCTAssertNil(perl.statistics.liveValues)
+		PerlValue.countsLiveInstances = true
+		defer { PerlValue.countsLiveInstances = false }
+		let before = perl.statistics
+		XCTAssertGreaterThan(before.svCount, 0)
+		XCTAssertGreaterThan(before.svArenas, 0)
+		XCTAssertGreaterThanOrEqual(before.svArenaSlots, before.svCount)
+		XCTAssertGreaterThan(before.tmpsStack.capacity, 0)
+		let values = (0..<10).map { PerlScalar($0) }
+		let sub = PerlSub { (a: Int) -> Int in a }
+		let after = perl.statistics
+		XCTAssertGreaterThanOrEqual(after.svCount, before.svCount + values.count)
+		XCTAssertEqual(after.liveValues, before.liveValues.map { $0 + values.count + 1 })
+		XCTAssertEqual(after.liveSubroutines, before.liveSubroutines + 1)
+		try perl.eval("my @a = (1) x 100_000")
+		let stack = perl.statistics.argumentStack
+		XCTAssertGreaterThanOrEqual(stack.capacity, 100_000)
+		XCTAssertLessThan(stack.depth, 100_000)
+		_fixLifetime(sub)
+	}
+
+	func testRecycler() throws {
+		let recycler = PerlInterpreterRecycler(policy: PerlInterpreterRecycler.Policy(maxRequests: 3))
+		let first = recycler.interpreter
+		XCTAssertEqual(PerlInterpreter.current.pointer, first.pointer)
+		try first.eval("$main::x = 'first'")
+		XCTAssertFalse(recycler.requestFinished())
+		XCTAssertFalse(recycler.requestFinished())
+		recycler.recycle()
+		let second = recycler.interpreter
+		XCTAssertNotEqual(second.pointer, first.pointer)
+		XCTAssertEqual(PerlInterpreter.current.pointer, second.pointer)
+		XCTAssertEqual(recycler.requests, 0)
+		XCTAssertEqual(recycler.recycled, 1)
+		XCTAssertFalse(try second.eval("defined $main::x") as Bool)
+		recycler.shutdown()
+	}
 }
 
 extension EmbedTests {
 	static var allTests: [(String, (EmbedTests) -> () throws -> Void)] {
 		return [
-			("testEmbedding", testEmbedding)
+			("testEmbedding", testEmbedding),
+			("testOptions", testOptions),
+			("testClone", testClone),
+			("testPool", testPool),
+			("testExecutor", testExecutor),
+			("testStatistics", testStatistics),
+			("testRecycler", testRecycler),
 		]
 	}
 }
@@ -4,6 +4,7 @@ import XCTest
 class InternalTests : EmbeddedTestCase {
 	static let allTests = [
 		("testSubclass", testSubclass),
+		("testMethodCacheLimit", testMethodCacheLimit),
 	]
 
 	func testSubclass() {
@@ -17,6 +18,22 @@ class InternalTests : EmbeddedTestCase {
 		XCTAssertFalse(isStrictSubclass(E.self, of: A.self))
 		XCTAssertFalse(isStrictSubclass(F.self, of: A.self))
 	}
+
+	func testMethodCacheLimit() throws {
+		let limit = PerlInterpreterContext.methodCacheLimit
+		try perl.eval("package EvictBase; sub name { 'base' } package main; no strict 'refs'; @{\"Evict${_}::ISA\"} = ('EvictBase') for 1..\(limit + 10)")
+		let first: PerlObject = try perl.eval("bless {}, 'Evict1'")
+		XCTAssertEqual(try first.call(method: "name") as String, "base")
+		let count = perl.context.cachedMethodCount
+		try perl.eval("no warnings 'redefine'; sub EvictBase::name { 'redefined' }")
+		XCTAssertEqual(try first.call(method: "name") as String, "redefined")
+		XCTAssertEqual(perl.context.cachedMethodCount, count)
+		for i in 2...(limit + 10) {
+			let obj: PerlObject = try perl.eval("bless {}, 'Evict\(i)'")
+			XCTAssertEqual(try obj.call(method: "name") as String, "redefined")
+			XCTAssertLessThanOrEqual(perl.context.cachedMethodCount, limit)
+		}
+	}
 }
 
 class A {}
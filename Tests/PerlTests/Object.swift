@@ -8,6 +8,7 @@ class ObjectTests : EmbeddedTestCase {
 			("testPerlObject", testPerlObject),
 			("testSwiftObject", testSwiftObject),
 			("testRefCnt", testRefCnt),
+			("testMethodCache", testMethodCache),
 		]
 	}
 
@@ -42,6 +43,33 @@ class ObjectTests : EmbeddedTestCase {
 		try perl.eval("TestRefCnt->new(); undef")
 		XCTAssertEqual(TestRefCnt.refcnt, 0)
 	}
+
+	func testMethodCache() throws {
+		try perl.eval("package CacheBase; sub new { bless {}, shift } sub name { 'base' } package CacheTest; our @ISA = ('CacheBase')")
+		let obj: PerlObject = try perl.eval("CacheTest->new()")
+		XCTAssertEqual(try obj.call(method: "name") as String, "base")
+		XCTAssertEqual(try CacheTest.call(method: "name") as String, "base")
+		try perl.eval("sub CacheBase::name { 'redefined' }")
+		XCTAssertEqual(try obj.call(method: "name") as String, "redefined")
+		try perl.eval("sub CacheTest::name { 'own' }")
+		XCTAssertEqual(try obj.call(method: "name") as String, "own")
+		XCTAssertEqual(try CacheTest.call(method: "name") as String, "own")
+		try perl.eval("@CacheTest::ISA = (); sub CacheTest::AUTOLOAD { 'autoloaded' } delete $CacheTest::{name}")
+		XCTAssertEqual(try obj.call(method: "name") as String, "autoloaded")
+		XCTAssertEqual(try obj.call(method: "CacheBase::name") as String, "redefined")
+		XCTAssertThrowsError(try MissingClass.call(method: "name", context: .void))
+		try perl.eval("sub CacheTest::invocant { $_[0] .= '::Renamed'; return $_[0] }")
+		XCTAssertEqual(try CacheTest.call(method: "invocant") as String, "CacheTest::Renamed")
+		XCTAssertEqual(try CacheTest.call(method: "invocant") as String, "CacheTest::Renamed")
+	}
+}
+
+final class CacheTest : PerlNamedClass {
+	static let perlClassName = "CacheTest"
+}
+
+final class MissingClass : PerlNamedClass {
+	static let perlClassName = "No::Such::Class"
 }
 
 final class URI : PerlObject, PerlNamedClass {